@@ -0,0 +1,58 @@
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace Optimization.Core.Algorithms;
+
+/// <summary>
+/// Fixed-size, direct-mapped memo of recent objective values keyed on the exact bits of the
+/// parameter vector, so re-evaluating a point the solver has already seen (a shrink or
+/// contraction landing on a known vertex once the simplex has collapsed to rounding level)
+/// costs a hash and a compare instead of an objective call. A colliding point replaces the
+/// entry. Mirrors Benchmarks/EvaluationCache.hpp.
+/// </summary>
+internal sealed class EvaluationCache<T> where T : unmanaged, IFloatingPoint<T>
+{
+    private readonly T[] _keys;
+    private readonly T[] _values;
+    private readonly bool[] _used;
+    private readonly int _n;
+    private readonly int _mask;
+
+    /// <summary>capacity is rounded up to a power of two</summary>
+    public EvaluationCache(int capacity, int n)
+    {
+        int slots = (int)BitOperations.RoundUpToPowerOf2((uint)Math.Max(capacity, 1));
+        _keys = new T[slots * n];
+        _values = new T[slots];
+        _used = new bool[slots];
+        _n = n;
+        _mask = slots - 1;
+    }
+
+    /// <summary>Slot of x; true, with its value, when the slot holds exactly x</summary>
+    public bool TryGet(ReadOnlySpan<T> x, out int slot, out T value)
+    {
+        var bytes = MemoryMarshal.AsBytes(x);
+        var hash = new HashCode();
+        hash.AddBytes(bytes);
+        slot = hash.ToHashCode() & _mask;
+
+        if (_used[slot] && MemoryMarshal.AsBytes(_keys.AsSpan(slot * _n, _n)).SequenceEqual(bytes))
+        {
+            value = _values[slot];
+            return true;
+        }
+        value = T.Zero;
+        return false;
+    }
+
+    /// <summary>Forgets every entry, for reuse by the next run</summary>
+    public void Clear() => Array.Clear(_used);
+
+    public void Store(int slot, ReadOnlySpan<T> x, T value)
+    {
+        x.CopyTo(_keys.AsSpan(slot * _n, _n));
+        _values[slot] = value;
+        _used[slot] = true;
+    }
+}
\ No newline at end of file
@@ -2,14 +2,83 @@ using System.Numerics;
 
 namespace Optimization.Core.Algorithms;
 
+/// <summary>
+/// How the simplex is kept inside LowerBounds/UpperBounds. Penalty adds 1e6 * violation^2 to the
+/// objective and lets vertices leave the box. Project clamps reflected and expanded points onto
+/// the box, as NLopt's Nelder-Mead does; Reflect mirrors them back across the violated bound and
+/// clamps what still lies outside. Contracted and shrunk points are convex combinations of
+/// vertices inside the box and need neither.
+/// </summary>
+public enum BoundsMode
+{
+    Penalty,
+    Project,
+    Reflect
+}
+
 public interface INelderMeadOptions<T> where T : IFloatingPoint<T>
 {
+    /// <summary>Absolute tolerance on the spread between the best and worst vertex values</summary>
     T FunctionTolerance { get; }
+
+    /// <summary>
+    /// Absolute tolerance on the extent of the simplex along every coordinate. Checked every
+    /// n + 1 replacements and after shrinks (NelderMeadOptimized only); 0 together with
+    /// RelativeParameterTolerance = 0 turns the test off
+    /// </summary>
     T ParameterTolerance { get; }
+
     int MaxIterations { get; }
     ReadOnlyMemory<T> LowerBounds { get; }
     ReadOnlyMemory<T> UpperBounds { get; }
     T InitialSimplexSize { get; }
+
+    /// <summary>
+    /// Gao-Han dimension-dependent coefficients: expansion 1 + 2/n, contraction 3/4 - 1/(2n) and
+    /// shrink 1 - 1/n instead of 2, 1/2 and 1/2, which keeps the simplex from flattening beyond
+    /// about 10 dimensions. The two sets coincide at n = 2.
+    /// </summary>
+    bool Adaptive => false;
+
+    /// <summary>
+    /// Simplex rebuilds around the best vertex allowed when the simplex flattens, stalls, or meets
+    /// the function tolerance without having been restarted from within it (NelderMeadOptimized only)
+    /// </summary>
+    int MaxRestarts => 0;
+
+    /// <summary>Iterations between stall checks; 0 = 10 n</summary>
+    int StallIterations => 0;
+
+    /// <summary>
+    /// NLopt ftol_rel: the function test also passes when the spread is within this fraction of
+    /// the mean of |f(best)| and |f(worst)|; 0 = off
+    /// </summary>
+    T RelativeFunctionTolerance => T.Zero;
+
+    /// <summary>
+    /// NLopt xtol_rel: the parameter test also passes for a coordinate whose extent is within
+    /// this fraction of its magnitude; 0 = off
+    /// </summary>
+    T RelativeParameterTolerance => T.Zero;
+
+    /// <summary>
+    /// Objective evaluation budget; 0 = unlimited. Checked once per iteration, so a shrink can
+    /// overrun it by up to n + 1 evaluations
+    /// </summary>
+    int MaxFunctionEvaluations => 0;
+
+    /// <summary>Wall-clock budget from the start of the run; TimeSpan.Zero = unlimited</summary>
+    TimeSpan MaxTime => TimeSpan.Zero;
+
+    /// <summary>
+    /// Entries (rounded up to a power of two) of a memo that returns the stored value when a
+    /// point is evaluated again bit for bit; 0 = off. Costs O(n) per evaluation, so it only pays
+    /// for expensive objectives (NelderMeadOptimized only)
+    /// </summary>
+    int CacheSize => 0;
+
+    /// <summary>Bounds handling (NelderMeadOptimized only; NelderMead always penalizes)</summary>
+    BoundsMode BoundsMode => BoundsMode.Penalty;
 }
 
 public class NelderMeadOptions<T> : INelderMeadOptions<T> where T : IFloatingPoint<T>
@@ -20,4 +89,13 @@ public class NelderMeadOptions<T> : INelderMeadOptions<T> where T : IFloatingPoi
     public ReadOnlyMemory<T> LowerBounds { get; set; } = ReadOnlyMemory<T>.Empty;
     public ReadOnlyMemory<T> UpperBounds { get; set; } = ReadOnlyMemory<T>.Empty;
     public T InitialSimplexSize { get; set; } = T.CreateChecked(0.05);
+    public bool Adaptive { get; set; }
+    public int MaxRestarts { get; set; }
+    public int StallIterations { get; set; }
+    public T RelativeFunctionTolerance { get; set; } = T.Zero;
+    public T RelativeParameterTolerance { get; set; } = T.Zero;
+    public int MaxFunctionEvaluations { get; set; }
+    public TimeSpan MaxTime { get; set; }
+    public int CacheSize { get; set; }
+    public BoundsMode BoundsMode { get; set; }
 }
\ No newline at end of file
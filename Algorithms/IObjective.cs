@@ -0,0 +1,25 @@
+using System.Runtime.CompilerServices;
+
+namespace Optimization.Core.Algorithms;
+
+/// <summary>
+/// Objective evaluated by NelderMeadOptimized. Implement on a struct to let the JIT specialize
+/// the solver and inline the evaluation into its loop, where a Func delegate costs an indirect
+/// call per evaluation. The solver copies the struct, so keep any state that must outlive an
+/// evaluation (counters, scratch buffers) behind a reference field.
+/// </summary>
+public interface IObjective<T>
+{
+    T Evaluate(ReadOnlySpan<T> parameters);
+}
+
+/// <summary>Adapts a delegate; the Func overloads of NelderMeadOptimized run on this</summary>
+public readonly struct DelegateObjective<T> : IObjective<T>
+{
+    private readonly Func<ReadOnlySpan<T>, T> _objective;
+
+    public DelegateObjective(Func<ReadOnlySpan<T>, T> objective) => _objective = objective;
+
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    public T Evaluate(ReadOnlySpan<T> parameters) => _objective(parameters);
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+using System.Numerics;
+
+namespace Optimization.Core.Algorithms;
+
+/// <summary>
+/// Fills the Gauss-Newton normal equations at the given parameters:
+/// J^T W J (n x n, row-major) into jtj and J^T W r into jtr, where
+/// r = y - model and J is the model Jacobian. Returns the sum of squared residuals.
+/// </summary>
+public delegate T NormalEquations<T>(ReadOnlySpan<T> parameters, Span<T> jtj, Span<T> jtr);
+
+public class LevenbergMarquardtOptions<T> where T : IFloatingPoint<T>
+{
+    public T FunctionTolerance { get; set; } = T.CreateChecked(1e-10);   // Relative SSR decrease
+    public T ParameterTolerance { get; set; } = T.CreateChecked(1e-10);  // Relative step length
+    public T GradientTolerance { get; set; } = T.CreateChecked(1e-12);   // Max |J^T W r|
+    public int MaxIterations { get; set; } = 200;
+    public T InitialLambda { get; set; } = T.CreateChecked(1e-3);
+    public ReadOnlyMemory<T> LowerBounds { get; set; } = ReadOnlyMemory<T>.Empty;
+    public ReadOnlyMemory<T> UpperBounds { get; set; } = ReadOnlyMemory<T>.Empty;
+}
+
+/// <summary>
+/// Levenberg-Marquardt for nonlinear least squares with box bounds. Each
+/// iteration solves (J^T W J + lambda diag(J^T W J)) delta = J^T W r by Cholesky
+/// and projects the step onto the bounds. Mirrors Benchmarks/LevenbergMarquardt.hpp.
+/// </summary>
+public static class LevenbergMarquardt<T> where T : IFloatingPoint<T>
+{
+    private static readonly T LambdaDecrease = T.CreateChecked(0.1);
+    private static readonly T LambdaIncrease = T.CreateChecked(10.0);
+    private static readonly T MinLambda = T.CreateChecked(1e-15);
+    private static readonly T MaxLambda = T.CreateChecked(1e16);
+    private static readonly T MinDiagonal = T.CreateChecked(1e-30);
+
+    public static OptimizationResult<T> Minimize(
+        NormalEquations<T> normalEquations,
+        ReadOnlySpan<T> initialGuess,
+        LevenbergMarquardtOptions<T>? options = null)
+    {
+        options ??= new LevenbergMarquardtOptions<T>();
+
+        int n = initialGuess.Length;
+        if (n == 0) throw new ArgumentException("Initial guess cannot be empty");
+
+        var lowerBounds = options.LowerBounds.Length >= n ? options.LowerBounds.Span : ReadOnlySpan<T>.Empty;
+        var upperBounds = options.UpperBounds.Length >= n ? options.UpperBounds.Span : ReadOnlySpan<T>.Empty;
+
+        var x = initialGuess.ToArray();
+        var trial = new T[n];
+        var delta = new T[n];
+        var jtr = new T[n];
+        var trialJtr = new T[n];
+        var jtj = new T[n * n];
+        var trialJtj = new T[n * n];
+        var system = new T[n * n];
+
+        Project(x, lowerBounds, upperBounds);
+        T ssr = normalEquations(x, jtj, jtr);
+        int functionEvaluations = 1;
+        T lambda = options.InitialLambda;
+
+        for (int iteration = 0; iteration < options.MaxIterations; iteration++)
+        {
+            if (MaxAbs(jtr) <= options.GradientTolerance)
+                return new OptimizationResult<T>(x, ssr, iteration, functionEvaluations, true, "Gradient tolerance reached");
+
+            while (true)
+            {
+                jtj.CopyTo(system, 0);
+                for (int k = 0; k < n; k++)
+                    system[k * n + k] += lambda * T.Max(jtj[k * n + k], MinDiagonal);
+
+                if (CholeskySolve(system, jtr, delta, n))
+                {
+                    for (int k = 0; k < n; k++) trial[k] = x[k] + delta[k];
+                    Project(trial, lowerBounds, upperBounds);
+
+                    T stepNorm = T.Zero;
+                    T xNorm = T.Zero;
+                    for (int k = 0; k < n; k++)
+                    {
+                        T step = trial[k] - x[k];
+                        stepNorm += step * step;
+                        xNorm += x[k] * x[k];
+                    }
+                    bool smallStep = Sqrt(stepNorm) <= options.ParameterTolerance * (Sqrt(xNorm) + options.ParameterTolerance);
+
+                    T trialSsr = normalEquations(trial, trialJtj, trialJtr);
+                    functionEvaluations++;
+
+                    if (trialSsr < ssr)
+                    {
+                        T decrease = ssr - trialSsr;
+                        T previous = ssr;
+                        (x, trial) = (trial, x);
+                        (jtj, trialJtj) = (trialJtj, jtj);
+                        (jtr, trialJtr) = (trialJtr, jtr);
+                        ssr = trialSsr;
+                        lambda = T.Max(lambda * LambdaDecrease, MinLambda);
+
+                        if (decrease <= options.FunctionTolerance * previous)
+                            return new OptimizationResult<T>(x, ssr, iteration + 1, functionEvaluations, true, "Function tolerance reached");
+                        if (smallStep)
+                            return new OptimizationResult<T>(x, ssr, iteration + 1, functionEvaluations, true, "Parameter tolerance reached");
+                        break;
+                    }
+
+                    // A projected step that no longer moves cannot improve
+                    if (smallStep)
+                        return new OptimizationResult<T>(x, ssr, iteration + 1, functionEvaluations, true, "Parameter tolerance reached");
+                }
+
+                lambda *= LambdaIncrease;
+                if (lambda > MaxLambda)
+                    return new OptimizationResult<T>(x, ssr, iteration + 1, functionEvaluations, false, "Damping limit reached");
+            }
+        }
+
+        return new OptimizationResult<T>(x, ssr, options.MaxIterations, functionEvaluations, false, "Maximum iterations reached");
+    }
+
+    private static void Project(Span<T> x, ReadOnlySpan<T> lowerBounds, ReadOnlySpan<T> upperBounds)
+    {
+        for (int k = 0; k < x.Length; k++)
+        {
+            if (!lowerBounds.IsEmpty && x[k] < lowerBounds[k]) x[k] = lowerBounds[k];
+            if (!upperBounds.IsEmpty && x[k] > upperBounds[k]) x[k] = upperBounds[k];
+        }
+    }
+
+    private static T MaxAbs(ReadOnlySpan<T> values)
+    {
+        T max = T.Zero;
+        for (int k = 0; k < values.Length; k++)
+            max = T.Max(max, T.Abs(values[k]));
+        return max;
+    }
+
+    private static T Sqrt(T value) => T.CreateChecked(Math.Sqrt(double.CreateChecked(value)));
+
+    /// <summary>
+    /// Solves a x = b for symmetric positive definite a, factoring in place (lower triangle).
+    /// Returns false if a is not positive definite.
+    /// </summary>
+    private static bool CholeskySolve(Span<T> a, ReadOnlySpan<T> b, Span<T> x, int n)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            T d = a[j * n + j];
+            for (int k = 0; k < j; k++) d -= a[j * n + k] * a[j * n + k];
+            if (!(d > T.Zero)) return false;
+            d = Sqrt(d);
+            a[j * n + j] = d;
+            for (int i = j + 1; i < n; i++)
+            {
+                T s = a[i * n + j];
+                for (int k = 0; k < j; k++) s -= a[i * n + k] * a[j * n + k];
+                a[i * n + j] = s / d;
+            }
+        }
+
+        // Forward substitution L y = b, then back substitution L^T x = y
+        for (int i = 0; i < n; i++)
+        {
+            T s = b[i];
+            for (int k = 0; k < i; k++) s -= a[i * n + k] * x[k];
+            x[i] = s / a[i * n + i];
+        }
+        for (int i = n - 1; i >= 0; i--)
+        {
+            T s = x[i];
+            for (int k = i + 1; k < n; k++) s -= a[k * n + i] * x[k];
+            x[i] = s / a[i * n + i];
+        }
+        return true;
+    }
+}
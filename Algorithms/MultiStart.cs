@@ -0,0 +1,176 @@
+using System.Numerics;
+
+namespace Optimization.Core.Algorithms;
+
+public class MultiStartOptions<T> where T : IFloatingPoint<T>
+{
+    /// <summary>Options for every local run; its bounds also bound the Latin hypercube starts</summary>
+    public INelderMeadOptions<T> LocalOptions { get; set; } = new NelderMeadOptions<T>();
+
+    /// <summary>Explicit starting points; when empty, Starts points are drawn by Latin hypercube</summary>
+    public IReadOnlyList<T[]> StartingPoints { get; set; } = Array.Empty<T[]>();
+
+    public int Starts { get; set; } = 8;
+    public int Seed { get; set; } = 0;
+
+    /// <summary>Iterations each live start runs between pruning checks</summary>
+    public int CheckInterval { get; set; } = 25;
+
+    /// <summary>Checks before any start can be pruned, so slow starters get a chance</summary>
+    public int GraceChecks { get; set; } = 2;
+
+    /// <summary>
+    /// A start is pruned when its best value exceeds the leader's by more than this fraction
+    /// of the larger of the two magnitudes
+    /// </summary>
+    public T PruneGap { get; set; } = T.CreateChecked(0.5);
+
+    /// <summary>Relative distance per parameter below which two minima are the same</summary>
+    public T DistinctTolerance { get; set; } = T.CreateChecked(1e-3);
+
+    public int MaxDegreeOfParallelism { get; set; } = -1;
+}
+
+public readonly struct MultiStartResult<T> where T : IFloatingPoint<T>
+{
+    public OptimizationResult<T> Best { get; init; }
+
+    /// <summary>Distinct minima of the starts that ran to completion, best first</summary>
+    public IReadOnlyList<OptimizationResult<T>> LocalMinima { get; init; }
+
+    public int Starts { get; init; }
+    public int Pruned { get; init; }
+
+    /// <summary>Evaluations over all starts, pruned ones included</summary>
+    public int FunctionEvaluations { get; init; }
+}
+
+/// <summary>
+/// Global search by running several Nelder-Mead starts side by side. Live starts advance
+/// CheckInterval iterations at a time in parallel; after each round, starts whose best value
+/// is dominated by the leader's are abandoned, so losing basins cost a few rounds instead of
+/// a full run. Rounds and pruning depend only on the values reached, so the result is the
+/// same for any degree of parallelism. The objective must be safe to call concurrently.
+/// </summary>
+public static class MultiStartNelderMead<T> where T : unmanaged, IFloatingPoint<T>
+{
+    public static MultiStartResult<T> Minimize(
+        Func<ReadOnlySpan<T>, T> objective,
+        MultiStartOptions<T> options)
+    {
+        var local = options.LocalOptions;
+        var points = options.StartingPoints.Count > 0
+            ? options.StartingPoints
+            : LatinHypercube(local.LowerBounds.Span, local.UpperBounds.Span, options.Starts, options.Seed);
+        if (points.Count == 0) throw new ArgumentException("At least one start is required");
+        if (options.CheckInterval <= 0) throw new ArgumentException("CheckInterval must be positive");
+
+        var runs = new NelderMeadOptimized<T>.Run<DelegateObjective<T>, NullSolverTrace>[points.Count];
+        var pruned = new bool[runs.Length];
+        var parallel = new ParallelOptions { MaxDegreeOfParallelism = options.MaxDegreeOfParallelism };
+        try
+        {
+            Parallel.For(0, runs.Length, parallel, i => runs[i] = NelderMeadOptimized<T>.Start(objective, points[i], local));
+
+            var live = new List<int>(runs.Length);
+            for (int i = 0; i < runs.Length; i++) live.Add(i);
+
+            for (int check = 1; live.Count > 0; check++)
+            {
+                Parallel.ForEach(live, parallel, i => runs[i].Step(options.CheckInterval));
+
+                // The leader is the best start so far, finished ones included
+                int leader = -1;
+                for (int i = 0; i < runs.Length; i++)
+                    if (!pruned[i] && (leader < 0 || runs[i].BestValue < runs[leader].BestValue)) leader = i;
+                T best = runs[leader].BestValue;
+
+                live.RemoveAll(i =>
+                {
+                    if (runs[i].IsFinished) return true;
+                    if (check <= options.GraceChecks || i == leader) return false;
+                    T value = runs[i].BestValue;
+                    T scale = T.Max(T.Abs(value), T.Abs(best));
+                    if (value - best <= options.PruneGap * scale) return false;
+                    pruned[i] = true;
+                    return true;
+                });
+            }
+
+            var finished = new List<OptimizationResult<T>>();
+            int evaluations = 0, prunedCount = 0;
+            for (int i = 0; i < runs.Length; i++)
+            {
+                evaluations += runs[i].FunctionEvaluations;
+                if (pruned[i]) prunedCount++;
+                else finished.Add(runs[i].Result);
+            }
+            finished.Sort((a, b) => a.OptimalValue.CompareTo(b.OptimalValue));
+
+            var minima = new List<OptimizationResult<T>>();
+            foreach (var result in finished)
+            {
+                bool seen = false;
+                foreach (var minimum in minima)
+                    seen |= SamePoint(result.OptimalParameters.Span, minimum.OptimalParameters.Span, options.DistinctTolerance);
+                if (!seen) minima.Add(result);
+            }
+
+            return new MultiStartResult<T>
+            {
+                Best = minima[0],
+                LocalMinima = minima,
+                Starts = runs.Length,
+                Pruned = prunedCount,
+                FunctionEvaluations = evaluations
+            };
+        }
+        finally
+        {
+            foreach (var run in runs) run?.Dispose();
+        }
+    }
+
+    /// <summary>
+    /// count points in the box, one in each of count equal slices of every dimension, with the
+    /// slices paired across dimensions at random
+    /// </summary>
+    public static T[][] LatinHypercube(ReadOnlySpan<T> lowerBounds, ReadOnlySpan<T> upperBounds, int count, int seed)
+    {
+        int n = lowerBounds.Length;
+        if (n == 0 || upperBounds.Length != n)
+            throw new ArgumentException("Latin hypercube starts need lower and upper bounds of equal length");
+        for (int j = 0; j < n; j++)
+        {
+            if (!T.IsFinite(lowerBounds[j]) || !T.IsFinite(upperBounds[j]) || upperBounds[j] < lowerBounds[j])
+                throw new ArgumentException("Latin hypercube starts need finite bounds with lower <= upper");
+        }
+
+        var random = new Random(seed);
+        var points = new T[count][];
+        for (int i = 0; i < count; i++) points[i] = new T[n];
+
+        var slices = new int[count];
+        for (int j = 0; j < n; j++)
+        {
+            for (int i = 0; i < count; i++) slices[i] = i;
+            random.Shuffle(slices);
+
+            double lower = double.CreateChecked(lowerBounds[j]);
+            double width = double.CreateChecked(upperBounds[j]) - lower;
+            for (int i = 0; i < count; i++)
+                points[i][j] = T.CreateChecked(lower + width * (slices[i] + random.NextDouble()) / count);
+        }
+        return points;
+    }
+
+    private static bool SamePoint(ReadOnlySpan<T> a, ReadOnlySpan<T> b, T tolerance)
+    {
+        for (int j = 0; j < a.Length; j++)
+        {
+            T scale = T.One + T.Max(T.Abs(a[j]), T.Abs(b[j]));
+            if (T.Abs(a[j] - b[j]) > tolerance * scale) return false;
+        }
+        return true;
+    }
+}
\ No newline at end of file
@@ -2,6 +2,7 @@ using System.Numerics;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using System.Buffers;
+using System.Diagnostics;
 
 namespace Optimization.Core.Algorithms;
 
@@ -20,21 +21,41 @@ public static class NelderMeadOptimized<T> where T : unmanaged, IFloatingPoint<T
     private static readonly T Zero = T.Zero;
     private static readonly T One = T.One;
 
+    /// <summary>Worst-vertex replacements between full re-sums of the running vertex sum</summary>
+    private const int CentroidRefreshInterval = 100;
+
+    /// <summary>Geometric-mean edge ratio below which the simplex counts as flattened (see IsDegenerate)</summary>
+    private static readonly double DegenerateRatio = 1e-4;
+
     /// <summary>
-    /// Optimized workspace for reusable arrays and reduced allocations
+    /// Per-run scratch arrays. Disposing a run parks its workspace in a per-thread slot and the
+    /// next run of the same dimension and cache size on that thread takes it over, so repeated
+    /// fits (a batch worker, a multi-start loop) allocate their scratch once per thread
     /// </summary>
-    private readonly struct OptimizationWorkspace : IDisposable
+    private sealed class OptimizationWorkspace
     {
         public readonly T[] Simplex;
         public readonly T[] Values;
         public readonly int[] Indices;
+        public readonly T[] VertexSum;
         public readonly T[] Centroid;
         public readonly T[] Reflected;
         public readonly T[] Expanded;
         public readonly T[] Contracted;
         public readonly T[] TempArray;
+        public readonly T[] Lower;
+        public readonly T[] Upper;
+        public readonly EvaluationCache<T>? Cache;
+        public readonly int Dimensions;
+        public readonly int CacheSize;
+
+        /// <summary>Gram-Schmidt scratch of IsDegenerate, created on the first restart check</summary>
+        public T[]? Basis;
+
+        [ThreadStatic]
+        private static OptimizationWorkspace? _spare;
 
-        public OptimizationWorkspace(int dimensions)
+        private OptimizationWorkspace(int dimensions, int cacheSize)
         {
             int n = dimensions;
             int simplexSize = (n + 1) * n;
@@ -51,14 +72,40 @@ public static class NelderMeadOptimized<T> where T : unmanaged, IFloatingPoint<T
             
             Values = new T[n + 1];
             Indices = new int[n + 1];
+            VertexSum = new T[n];
             Centroid = new T[n];
             Reflected = new T[n];
             Expanded = new T[n];
             Contracted = new T[n];
             TempArray = new T[n];
+            Lower = new T[n];
+            Upper = new T[n];
+            Cache = cacheSize > 0 ? new EvaluationCache<T>(cacheSize, n) : null;
+            Dimensions = n;
+            CacheSize = cacheSize;
         }
 
-        public void Dispose()
+        /// <summary>This thread's parked workspace when it fits, otherwise a new one</summary>
+        public static OptimizationWorkspace Rent(int dimensions, int cacheSize)
+        {
+            var spare = _spare;
+            if (spare != null && spare.Dimensions == dimensions && spare.CacheSize == cacheSize)
+            {
+                _spare = null;
+                spare.Cache?.Clear();
+                return spare;
+            }
+            return new OptimizationWorkspace(dimensions, cacheSize);
+        }
+
+        /// <summary>Parks the workspace for the next run on this thread, releasing the one it replaces</summary>
+        public void Return()
+        {
+            _spare?.Release();
+            _spare = this;
+        }
+
+        private void Release()
         {
             if (Simplex.Length > 1024)
             {
@@ -71,185 +118,627 @@ public static class NelderMeadOptimized<T> where T : unmanaged, IFloatingPoint<T
         Func<ReadOnlySpan<T>, T> objective,
         ReadOnlySpan<T> initialGuess,
         INelderMeadOptions<T>? options = null)
+    {
+        return Minimize(new DelegateObjective<T>(objective), initialGuess, options, new NullSolverTrace());
+    }
+
+    /// <summary>
+    /// Minimize with telemetry: pass a SolverTrace to record operations, phase timings
+    /// and the best-value history of this run
+    /// </summary>
+    public static OptimizationResult<T> Minimize<TTrace>(
+        Func<ReadOnlySpan<T>, T> objective,
+        ReadOnlySpan<T> initialGuess,
+        INelderMeadOptions<T>? options,
+        TTrace trace) where TTrace : ISolverTrace
+    {
+        return Minimize(new DelegateObjective<T>(objective), initialGuess, options, trace);
+    }
+
+    /// <summary>
+    /// Minimize a struct objective; the solver is specialized for TObjective, so its Evaluate
+    /// inlines instead of going through a delegate
+    /// </summary>
+    public static OptimizationResult<T> Minimize<TObjective>(
+        TObjective objective,
+        ReadOnlySpan<T> initialGuess,
+        INelderMeadOptions<T>? options = null) where TObjective : struct, IObjective<T>
+    {
+        return Minimize(objective, initialGuess, options, new NullSolverTrace());
+    }
+
+    public static OptimizationResult<T> Minimize<TObjective, TTrace>(
+        TObjective objective,
+        ReadOnlySpan<T> initialGuess,
+        INelderMeadOptions<T>? options,
+        TTrace trace) where TObjective : struct, IObjective<T> where TTrace : ISolverTrace
     {
         options ??= new NelderMeadOptions<T>();
-        
-        int n = initialGuess.Length;
-        if (n == 0) throw new ArgumentException("Initial guess cannot be empty");
+        using var run = new Run<TObjective, TTrace>(objective, initialGuess, options, trace);
+        run.Step(options.MaxIterations);
+        return run.Result;
+    }
 
-        // Use workspace pattern to reduce allocations
-        using var workspace = new OptimizationWorkspace(n);
-        
-        // Pre-compute bounds spans to avoid repeated Memory.Span calls
-        var lowerBounds = options.LowerBounds.IsEmpty ? ReadOnlySpan<T>.Empty : options.LowerBounds.Span;
-        var upperBounds = options.UpperBounds.IsEmpty ? ReadOnlySpan<T>.Empty : options.UpperBounds.Span;
-        bool hasBounds = !lowerBounds.IsEmpty || !upperBounds.IsEmpty;
+    /// <summary>
+    /// Minimize into a caller-owned buffer: the solution is written to solution[..n] and
+    /// OptimalParameters refers to it. Batch callers pass slices of one contiguous results array;
+    /// with the thread's workspace reused, a fit then allocates only the run object itself.
+    /// </summary>
+    public static OptimizationResult<T> Minimize<TObjective>(
+        TObjective objective,
+        ReadOnlySpan<T> initialGuess,
+        Memory<T> solution,
+        INelderMeadOptions<T>? options = null) where TObjective : struct, IObjective<T>
+    {
+        if (solution.Length < initialGuess.Length)
+            throw new ArgumentException("Solution buffer is shorter than the initial guess");
+        options ??= new NelderMeadOptions<T>();
+        using var run = new Run<TObjective, NullSolverTrace>(objective, initialGuess, options, new NullSolverTrace(), solution);
+        run.Step(options.MaxIterations);
+        return run.Result;
+    }
 
-        // Initialize simplex
-        InitializeSimplexOptimized(initialGuess, options.InitialSimplexSize, lowerBounds, upperBounds, workspace.Simplex, n);
-        
-        int functionEvaluations = 0;
-        
-        // Evaluate initial simplex
-        for (int i = 0; i <= n; i++)
-        {
-            var vertex = workspace.Simplex.AsSpan(i * n, n);
-            workspace.Values[i] = hasBounds ? 
-                EvaluateWithBounds(objective, vertex, lowerBounds, upperBounds) : 
-                objective(vertex);
-            workspace.Indices[i] = i;
-            functionEvaluations++;
-        }
+    /// <summary>
+    /// Starts a minimization that is advanced with <see cref="Run{TObjective, TTrace}.Step"/>
+    /// instead of running to completion, so callers can inspect or abandon it between steps
+    /// </summary>
+    public static Run<DelegateObjective<T>, NullSolverTrace> Start(
+        Func<ReadOnlySpan<T>, T> objective,
+        ReadOnlySpan<T> initialGuess,
+        INelderMeadOptions<T>? options = null)
+    {
+        return Start(new DelegateObjective<T>(objective), initialGuess, options);
+    }
+
+    public static Run<TObjective, NullSolverTrace> Start<TObjective>(
+        TObjective objective,
+        ReadOnlySpan<T> initialGuess,
+        INelderMeadOptions<T>? options = null) where TObjective : struct, IObjective<T>
+    {
+        return new Run<TObjective, NullSolverTrace>(objective, initialGuess, options ?? new NelderMeadOptions<T>(), new NullSolverTrace());
+    }
+
+    /// <summary>
+    /// One minimization, resumable between iterations. The constructor evaluates the initial
+    /// simplex; each Step runs up to the given number of iterations and stops early on
+    /// convergence, at MaxIterations or when the evaluation or time budget runs out. Running
+    /// Step to the end gives exactly the result of Minimize. Dispose hands the scratch arrays
+    /// to the next run on the same thread.
+    /// </summary>
+    public sealed class Run<TObjective, TTrace> : IDisposable
+        where TObjective : struct, IObjective<T>
+        where TTrace : ISolverTrace
+    {
+        private readonly TObjective _objective;
+        private readonly INelderMeadOptions<T> _options;
+        private readonly OptimizationWorkspace _workspace;
+        private readonly int _n;
+
+        // Bounds as dense arrays, -inf/+inf where a side is absent; null when unbounded.
+        // _penalize in BoundsMode.Penalty, _confine in Project and Reflect
+        private readonly T[]? _lower;
+        private readonly T[]? _upper;
+        private readonly bool _penalize;
+        private readonly bool _confine;
+        private readonly bool _mirror;
+        private TTrace _trace;
+        private int _iteration;
+        private int _functionEvaluations;
+        private int _replacements;
+        private OptimizationResult<T>? _result;
 
-        // Main optimization loop
-        for (int iteration = 0; iteration < options.MaxIterations; iteration++)
+        // Gao-Han coefficients when options.Adaptive, the classic ones otherwise
+        private readonly T _gamma;
+        private readonly T _rho;
+        private readonly T _sigma;
+
+        // Restart state: stall window and the best value the last restart began from
+        private readonly int _stallWindow;
+        private int _restarts;
+        private int _windowStart;
+        private T _windowMean;
+        private T _restartValue;
+
+        // Parameter test schedule (see ExtentWithin) and the start of the MaxTime budget
+        private readonly bool _trackExtent;
+        private bool _extentDue;
+        private readonly long _started;
+
+        // Caller-owned destination of the solution; empty to allocate one when the run finishes
+        private readonly Memory<T> _solution;
+        private bool _disposed;
+
+        internal Run(
+            TObjective objective,
+            ReadOnlySpan<T> initialGuess,
+            INelderMeadOptions<T> options,
+            TTrace trace,
+            Memory<T> solution = default)
         {
-            // Optimized sorting for small arrays
-            SortVerticesOptimized(workspace.Values, workspace.Indices);
-            
-            int best = workspace.Indices[0];
-            int worst = workspace.Indices[n];
-            int secondWorst = workspace.Indices[n - 1];
+            int n = initialGuess.Length;
+            if (n == 0) throw new ArgumentException("Initial guess cannot be empty");
+            if (!solution.IsEmpty && solution.Length < n)
+                throw new ArgumentException("Solution buffer is shorter than the initial guess");
+
+            _objective = objective;
+            _options = options;
+            _trace = trace;
+            _n = n;
+            _solution = solution.IsEmpty ? solution : solution[..n];
 
-            // Check convergence with fast comparison
-            T functionSpread = workspace.Values[worst] - workspace.Values[best];
-            if (functionSpread <= options.FunctionTolerance)
+            if (options.Adaptive)
             {
-                // Copy result efficiently
-                var result = new T[n];
-                workspace.Simplex.AsSpan(best * n, n).CopyTo(result);
-                return new OptimizationResult<T>(
-                    result, workspace.Values[best], iteration, functionEvaluations, true, "Function tolerance reached");
+                T d = T.CreateChecked(Math.Max(n, 2));
+                _gamma = One + T.CreateChecked(2) / d;
+                _rho = T.CreateChecked(0.75) - One / (T.CreateChecked(2) * d);
+                _sigma = One - One / d;
             }
+            else
+            {
+                _gamma = Gamma;
+                _rho = Rho;
+                _sigma = Sigma;
+            }
+            _stallWindow = options.StallIterations > 0 ? options.StallIterations : 10 * n;
+            _windowMean = T.CreateChecked(double.PositiveInfinity);
+            _restartValue = _windowMean;
+            _trackExtent = options.ParameterTolerance > Zero || options.RelativeParameterTolerance > Zero;
+            _extentDue = _trackExtent;
+            _started = Stopwatch.GetTimestamp();
 
-            // Calculate centroid - optimized with SIMD potential
-            CalculateCentroidOptimized(workspace.Simplex, workspace.Indices, workspace.Centroid, worst, n);
+            // Scratch comes from this thread's last run when it has the same shape
+            _workspace = OptimizationWorkspace.Rent(n, options.CacheSize);
+            var workspace = _workspace;
 
-            // Reflection
-            var worstVertex = workspace.Simplex.AsSpan(worst * n, n);
-            ReflectOptimized(worstVertex, workspace.Centroid, workspace.Reflected);
-            
-            T reflectedValue = hasBounds ? 
-                EvaluateWithBounds(objective, workspace.Reflected, lowerBounds, upperBounds) : 
-                objective(workspace.Reflected);
-            functionEvaluations++;
+            if (!options.LowerBounds.IsEmpty || !options.UpperBounds.IsEmpty)
+            {
+                NormalizeBounds(options.LowerBounds.Span, options.UpperBounds.Span, workspace.Lower, workspace.Upper);
+                _lower = workspace.Lower;
+                _upper = workspace.Upper;
+                _penalize = options.BoundsMode == BoundsMode.Penalty;
+                _confine = !_penalize;
+                _mirror = options.BoundsMode == BoundsMode.Reflect;
+            }
+            ReadOnlySpan<T> lowerBounds = _lower;
+            ReadOnlySpan<T> upperBounds = _upper;
 
-            if (workspace.Values[best] <= reflectedValue && reflectedValue < workspace.Values[secondWorst])
+            // Initialize simplex
+            InitializeSimplexOptimized(initialGuess, options.InitialSimplexSize, lowerBounds, upperBounds, workspace.Simplex, n);
+            if (_confine)
             {
-                // Accept reflection - fast copy
-                workspace.Reflected.CopyTo(worstVertex);
-                workspace.Values[worst] = reflectedValue;
-                continue;
+                for (int i = 0; i <= n; i++)
+                    ConfineToBox(workspace.Simplex.AsSpan(i * n, n), lowerBounds, upperBounds, _mirror);
             }
 
-            if (reflectedValue < workspace.Values[best])
+            _trace.Begin(n);
+
+            // Evaluate initial simplex
+            for (int i = 0; i <= n; i++)
             {
-                // Try expansion
-                ExpandOptimized(workspace.Centroid, workspace.Reflected, workspace.Expanded);
-                T expandedValue = hasBounds ? 
-                    EvaluateWithBounds(objective, workspace.Expanded, lowerBounds, upperBounds) : 
-                    objective(workspace.Expanded);
-                functionEvaluations++;
+                var vertex = workspace.Simplex.AsSpan(i * n, n);
+                workspace.Values[i] = Evaluate(objective, vertex, lowerBounds, upperBounds, _penalize, workspace.Cache, _trace);
+                workspace.Indices[i] = i;
+                _functionEvaluations++;
+            }
+            _trace.Operation(NelderMeadOperation.Initialize, _functionEvaluations);
+
+            // The centroid comes from a running sum of all n+1 vertices, updated in O(n)
+            // per replacement and re-summed after shrinks and every CentroidRefreshInterval
+            // replacements to bound rounding drift
+            SumVertices(workspace.Simplex, workspace.VertexSum, n);
+        }
+
+        public bool IsFinished => _result.HasValue;
+        public int Iterations => _iteration;
+        public int FunctionEvaluations => _functionEvaluations;
+        public int Restarts => _restarts;
+
+        /// <summary>Lowest value in the current simplex</summary>
+        public T BestValue
+        {
+            get
+            {
+                ObjectDisposedException.ThrowIf(_disposed, this);
+                return _workspace.Values[BestVertex()];
+            }
+        }
+
+        /// <summary>Vertex with the lowest value in the current simplex</summary>
+        public ReadOnlySpan<T> BestPoint
+        {
+            get
+            {
+                ObjectDisposedException.ThrowIf(_disposed, this);
+                return _workspace.Simplex.AsSpan(BestVertex() * _n, _n);
+            }
+        }
+
+        /// <summary>Final result; only available once the run has finished</summary>
+        public OptimizationResult<T> Result =>
+            _result ?? throw new InvalidOperationException("The minimization has not finished");
 
-                if (expandedValue < reflectedValue)
+        /// <summary>
+        /// Runs up to iterations more iterations. Returns true once the run has finished.
+        /// </summary>
+        public bool Step(int iterations)
+        {
+            ObjectDisposedException.ThrowIf(_disposed, this);
+            if (_result.HasValue) return true;
+
+            var workspace = _workspace;
+            var options = _options;
+            var objective = _objective;
+            int n = _n;
+            bool hasBounds = _penalize;
+            bool confine = _confine;
+            ReadOnlySpan<T> lowerBounds = _lower;
+            ReadOnlySpan<T> upperBounds = _upper;
+            int functionEvaluations = _functionEvaluations;
+            int replacements = _replacements;
+            int iteration = _iteration;
+            bool extentDue = _extentDue;
+            var trace = _trace;
+            int end = options.MaxIterations - iteration > iterations ? iteration + iterations : options.MaxIterations;
+
+            // Main optimization loop
+            for (; iteration < end; iteration++)
+            {
+                // Optimized sorting for small arrays
+                long started = trace.Clock();
+                SortVerticesOptimized(workspace.Values, workspace.Indices);
+                trace.Phase(SolverPhase.Sort, started);
+
+                int best = workspace.Indices[0];
+                int worst = workspace.Indices[n];
+                int secondWorst = workspace.Indices[n - 1];
+                if (trace.Enabled)
+                    trace.Best(iteration, functionEvaluations, double.CreateChecked(workspace.Values[best]));
+
+                // Check convergence: function spread every iteration, simplex extent when due
+                bool functionConverged = Within(workspace.Values[worst], workspace.Values[best],
+                                                options.FunctionTolerance, options.RelativeFunctionTolerance);
+                bool parametersConverged = false;
+                if (!functionConverged && extentDue)
+                {
+                    extentDue = false;
+                    parametersConverged = ExtentWithin(workspace.Simplex, n, options.ParameterTolerance, options.RelativeParameterTolerance);
+                }
+                if (functionConverged || parametersConverged)
+                {
+                    // A simplex that collapsed short of the minimum gets a fresh one; a true
+                    // minimum is confirmed by one restart that cannot improve on it
+                    if (_restarts < options.MaxRestarts &&
+                        (!Within(_restartValue, workspace.Values[best], options.FunctionTolerance, options.RelativeFunctionTolerance) ||
+                         IsDegenerate()))
+                    {
+                        Restart(best, iteration, ref functionEvaluations, ref trace, lowerBounds, upperBounds);
+                        replacements = 0;
+                        extentDue = _trackExtent;
+                        continue;
+                    }
+
+                    Finish(best, iteration, functionEvaluations, true,
+                           functionConverged ? "Function tolerance reached" : "Parameter tolerance reached", ref trace);
+                    break;
+                }
+
+                if (options.MaxFunctionEvaluations > 0 && functionEvaluations >= options.MaxFunctionEvaluations)
+                {
+                    Finish(best, iteration, functionEvaluations, false, "Maximum evaluations reached", ref trace);
+                    break;
+                }
+                if (options.MaxTime > TimeSpan.Zero && Stopwatch.GetElapsedTime(_started) >= options.MaxTime)
+                {
+                    Finish(best, iteration, functionEvaluations, false, "Maximum time reached", ref trace);
+                    break;
+                }
+
+                // Stalled: the mean vertex value moved by at most the function tolerance over the window
+                if (_restarts < options.MaxRestarts && iteration - _windowStart >= _stallWindow)
                 {
-                    workspace.Expanded.CopyTo(worstVertex);
-                    workspace.Values[worst] = expandedValue;
+                    T mean = Zero;
+                    for (int i = 0; i <= n; i++) mean += workspace.Values[i];
+                    mean /= T.CreateChecked(n + 1);
+                    bool stalled = Within(_windowMean, mean, options.FunctionTolerance, options.RelativeFunctionTolerance);
+                    _windowStart = iteration;
+                    _windowMean = mean;
+                    if (stalled || IsDegenerate())
+                    {
+                        Restart(best, iteration, ref functionEvaluations, ref trace, lowerBounds, upperBounds);
+                        replacements = 0;
+                        extentDue = _trackExtent;
+                        continue;
+                    }
                 }
-                else
+
+                var worstVertex = workspace.Simplex.AsSpan(worst * n, n);
+                started = trace.Clock();
+                CalculateCentroidOptimized(workspace.VertexSum, worstVertex, workspace.Centroid, n);
+                trace.Phase(SolverPhase.Centroid, started);
+
+                // Reflection
+                ReflectOptimized(worstVertex, workspace.Centroid, workspace.Reflected);
+                if (confine) ConfineToBox(workspace.Reflected, lowerBounds, upperBounds, _mirror);
+
+                T reflectedValue = Evaluate(objective, workspace.Reflected, lowerBounds, upperBounds, hasBounds, workspace.Cache, trace);
+                functionEvaluations++;
+
+                if (workspace.Values[best] <= reflectedValue && reflectedValue < workspace.Values[secondWorst])
                 {
-                    workspace.Reflected.CopyTo(worstVertex);
+                    // Accept reflection
+                    ReplaceWorst(workspace, worstVertex, workspace.Reflected, ref replacements, ref extentDue, _trackExtent);
                     workspace.Values[worst] = reflectedValue;
+                    trace.Operation(NelderMeadOperation.Reflect, 1);
+                    continue;
+                }
+
+                if (reflectedValue < workspace.Values[best])
+                {
+                    // Try expansion
+                    ExpandOptimized(workspace.Centroid, workspace.Reflected, workspace.Expanded, _gamma);
+                    if (confine) ConfineToBox(workspace.Expanded, lowerBounds, upperBounds, _mirror);
+                    T expandedValue = Evaluate(objective, workspace.Expanded, lowerBounds, upperBounds, hasBounds, workspace.Cache, trace);
+                    functionEvaluations++;
+
+                    if (expandedValue < reflectedValue)
+                    {
+                        ReplaceWorst(workspace, worstVertex, workspace.Expanded, ref replacements, ref extentDue, _trackExtent);
+                        workspace.Values[worst] = expandedValue;
+                    }
+                    else
+                    {
+                        ReplaceWorst(workspace, worstVertex, workspace.Reflected, ref replacements, ref extentDue, _trackExtent);
+                        workspace.Values[worst] = reflectedValue;
+                    }
+                    trace.Operation(NelderMeadOperation.Expand, 2);
+                    continue;
+                }
+
+                // Contraction
+                bool useReflected = reflectedValue < workspace.Values[worst];
+                var contractionPoint = useReflected ?
+                    workspace.Reflected.AsSpan() :
+                    worstVertex;
+
+                ContractOptimized(workspace.Centroid, contractionPoint, workspace.Contracted, _rho);
+                T contractedValue = Evaluate(objective, workspace.Contracted, lowerBounds, upperBounds, hasBounds, workspace.Cache, trace);
+                functionEvaluations++;
+
+                T comparisonValue = useReflected ? reflectedValue : workspace.Values[worst];
+                if (contractedValue < comparisonValue)
+                {
+                    ReplaceWorst(workspace, worstVertex, workspace.Contracted, ref replacements, ref extentDue, _trackExtent);
+                    workspace.Values[worst] = contractedValue;
+                    trace.Operation(useReflected ? NelderMeadOperation.ContractOutside : NelderMeadOperation.ContractInside, 2);
+                    continue;
+                }
+
+                // Shrink simplex toward best vertex
+                ShrinkSimplexOptimized(workspace.Simplex, workspace.Indices, best, n, _sigma);
+                for (int i = 1; i <= n; i++)
+                {
+                    var vertex = workspace.Simplex.AsSpan(workspace.Indices[i] * n, n);
+                    workspace.Values[workspace.Indices[i]] = Evaluate(objective, vertex, lowerBounds, upperBounds, hasBounds, workspace.Cache, trace);
+                    functionEvaluations++;
                 }
-                continue;
+                SumVertices(workspace.Simplex, workspace.VertexSum, n);
+                replacements = 0;
+                extentDue = _trackExtent;
+                trace.Operation(NelderMeadOperation.Shrink, 2 + n);
             }
 
-            // Contraction
-            bool useReflected = reflectedValue < workspace.Values[worst];
-            var contractionPoint = useReflected ? 
-                workspace.Reflected.AsSpan() : 
-                worstVertex;
-            
-            ContractOptimized(workspace.Centroid, contractionPoint, workspace.Contracted);
-            T contractedValue = hasBounds ? 
-                EvaluateWithBounds(objective, workspace.Contracted, lowerBounds, upperBounds) : 
-                objective(workspace.Contracted);
-            functionEvaluations++;
-
-            T comparisonValue = useReflected ? reflectedValue : workspace.Values[worst];
-            if (contractedValue < comparisonValue)
+            _iteration = iteration;
+            _functionEvaluations = functionEvaluations;
+            _replacements = replacements;
+            _extentDue = extentDue;
+
+            if (!_result.HasValue && iteration >= options.MaxIterations)
             {
-                workspace.Contracted.CopyTo(worstVertex);
-                workspace.Values[worst] = contractedValue;
-                continue;
+                // Return best result found
+                SortVerticesOptimized(workspace.Values, workspace.Indices);
+                Finish(workspace.Indices[0], options.MaxIterations, functionEvaluations, false, "Maximum iterations reached", ref trace);
             }
+            _trace = trace;
+            return _result.HasValue;
+        }
+
+        /// <summary>
+        /// Hands the workspace to the next run on this thread. Step, BestValue and BestPoint throw
+        /// ObjectDisposedException afterwards; Result and the counters stay readable.
+        /// </summary>
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+            _workspace.Return();
+        }
+
+        private void Finish(int best, int iteration, int functionEvaluations, bool converged, string message, ref TTrace trace)
+        {
+            Memory<T> result = _solution.IsEmpty ? new T[_n] : _solution;
+            _workspace.Simplex.AsSpan(best * _n, _n).CopyTo(result.Span);
+            trace.End(iteration);
+            _result = new OptimizationResult<T>(
+                result, _workspace.Values[best], iteration, functionEvaluations, converged, message)
+            {
+                Restarts = _restarts
+            };
+        }
 
-            // Shrink simplex toward best vertex
-            ShrinkSimplexOptimized(workspace.Simplex, workspace.Indices, best, n);
+        /// <summary>
+        /// Rebuilds the simplex around the best vertex, which becomes vertex 0, and evaluates the
+        /// n new vertices
+        /// </summary>
+        private void Restart(
+            int best,
+            int iteration,
+            ref int functionEvaluations,
+            ref TTrace trace,
+            ReadOnlySpan<T> lowerBounds,
+            ReadOnlySpan<T> upperBounds)
+        {
+            var workspace = _workspace;
+            int n = _n;
+            workspace.Simplex.AsSpan(best * n, n).CopyTo(workspace.TempArray);
+            T bestValue = workspace.Values[best];
+            InitializeSimplexOptimized(workspace.TempArray, _options.InitialSimplexSize, lowerBounds, upperBounds, workspace.Simplex, n);
+            workspace.Values[0] = bestValue;
+            workspace.Indices[0] = 0;
             for (int i = 1; i <= n; i++)
             {
-                var vertex = workspace.Simplex.AsSpan(workspace.Indices[i] * n, n);
-                workspace.Values[workspace.Indices[i]] = hasBounds ? 
-                    EvaluateWithBounds(objective, vertex, lowerBounds, upperBounds) : 
-                    objective(vertex);
+                var vertex = workspace.Simplex.AsSpan(i * n, n);
+                if (_confine) ConfineToBox(vertex, lowerBounds, upperBounds, _mirror);
+                workspace.Values[i] = Evaluate(_objective, vertex, lowerBounds, upperBounds, _penalize, workspace.Cache, trace);
+                workspace.Indices[i] = i;
                 functionEvaluations++;
             }
+            SumVertices(workspace.Simplex, workspace.VertexSum, n);
+
+            _restarts++;
+            _restartValue = bestValue;
+            _windowStart = iteration;
+            _windowMean = T.CreateChecked(double.PositiveInfinity);
+            trace.Operation(NelderMeadOperation.Restart, n);
         }
 
-        // Return best result found
-        SortVerticesOptimized(workspace.Values, workspace.Indices);
-        var finalResult = new T[n];
-        workspace.Simplex.AsSpan(workspace.Indices[0] * n, n).CopyTo(finalResult);
-        
-        return new OptimizationResult<T>(
-            finalResult, workspace.Values[workspace.Indices[0]], options.MaxIterations, functionEvaluations, false, "Maximum iterations reached");
+        /// <summary>
+        /// True when the simplex has flattened: with e_i the edges from the best vertex, the geometric
+        /// mean of |orthogonal part of e_i| / |e_i| (Gram-Schmidt), i.e. (|det E| / prod |e_i|)^(1/n), is
+        /// about 0.7 for a regular simplex and tends to 0 as the vertices fall into a hyperplane
+        /// </summary>
+        private bool IsDegenerate()
+        {
+            int n = _n;
+            var simplex = _workspace.Simplex;
+            var indices = _workspace.Indices;
+            var basis = _workspace.Basis ??= new T[n * n];
+            SortVerticesOptimized(_workspace.Values, indices);
+            var bestVertex = simplex.AsSpan(indices[0] * n, n);
+
+            double logRatio = 0.0;
+            for (int i = 0; i < n; i++)
+            {
+                var e = basis.AsSpan(i * n, n);
+                var vertex = simplex.AsSpan(indices[i + 1] * n, n);
+                T length2 = Zero;
+                for (int j = 0; j < n; j++)
+                {
+                    e[j] = vertex[j] - bestVertex[j];
+                    length2 += e[j] * e[j];
+                }
+                for (int k = 0; k < i; k++)
+                {
+                    var q = basis.AsSpan(k * n, n);
+                    T dot = Zero;
+                    for (int j = 0; j < n; j++) dot += q[j] * e[j];
+                    for (int j = 0; j < n; j++) e[j] -= dot * q[j];
+                }
+                T norm2 = Zero;
+                for (int j = 0; j < n; j++) norm2 += e[j] * e[j];
+                if (!(norm2 > Zero) || !(length2 > Zero)) return true;
+
+                double norm = Math.Sqrt(double.CreateChecked(norm2));
+                logRatio += Math.Log(norm / Math.Sqrt(double.CreateChecked(length2)));
+                T inverse = T.CreateChecked(1.0 / norm);
+                for (int j = 0; j < n; j++) e[j] *= inverse;
+            }
+            return logRatio < n * Math.Log(DegenerateRatio);
+        }
+
+        private int BestVertex()
+        {
+            var values = _workspace.Values;
+            int best = 0;
+            for (int i = 1; i <= _n; i++)
+                if (values[i] < values[best]) best = i;
+            return best;
+        }
     }
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    private static T EvaluateWithBounds(
-        Func<ReadOnlySpan<T>, T> objective,
+    private static T Evaluate<TObjective, TTrace>(
+        TObjective objective,
+        ReadOnlySpan<T> parameters,
+        ReadOnlySpan<T> lowerBounds,
+        ReadOnlySpan<T> upperBounds,
+        bool hasBounds,
+        EvaluationCache<T>? cache,
+        TTrace trace) where TObjective : struct, IObjective<T> where TTrace : ISolverTrace
+    {
+        // Hits still count as function evaluations; the trace reports how many skipped the objective
+        int slot = 0;
+        if (cache != null)
+        {
+            bool hit = cache.TryGet(parameters, out slot, out T cachedValue);
+            trace.Cache(hit);
+            if (hit) return cachedValue;
+        }
+
+        long started = trace.Clock();
+        T value = hasBounds ? 
+            EvaluateWithBounds(objective, parameters, lowerBounds, upperBounds) : 
+            objective.Evaluate(parameters);
+        trace.Phase(SolverPhase.Objective, started);
+        cache?.Store(slot, parameters, value);
+        return value;
+    }
+
+    /// <summary>
+    /// Quadratic penalty over dense bounds. Branch-free: an absent side is infinite and
+    /// contributes Max(-inf, 0) = 0
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static T EvaluateWithBounds<TObjective>(
+        TObjective objective,
         ReadOnlySpan<T> parameters,
         ReadOnlySpan<T> lowerBounds,
-        ReadOnlySpan<T> upperBounds)
+        ReadOnlySpan<T> upperBounds) where TObjective : struct, IObjective<T>
     {
         T penalty = Zero;
-        
-        // Unrolled bounds checking for common small dimensions
-        if (parameters.Length <= 6)
+        for (int i = 0; i < parameters.Length; i++)
         {
-            for (int i = 0; i < parameters.Length; i++)
-            {
-                if (i < lowerBounds.Length && parameters[i] < lowerBounds[i])
-                {
-                    T violation = lowerBounds[i] - parameters[i];
-                    penalty += PenaltyFactor * violation * violation;
-                }
-                if (i < upperBounds.Length && parameters[i] > upperBounds[i])
-                {
-                    T violation = parameters[i] - upperBounds[i];
-                    penalty += PenaltyFactor * violation * violation;
-                }
-            }
+            T below = T.Max(lowerBounds[i] - parameters[i], Zero);
+            T above = T.Max(parameters[i] - upperBounds[i], Zero);
+            penalty += PenaltyFactor * (below * below + above * above);
         }
-        else
+
+        return objective.Evaluate(parameters) + penalty;
+    }
+
+    /// <summary>
+    /// Copies the bounds into the n-element lower and upper, -inf/+inf where a side is absent or
+    /// shorter than n
+    /// </summary>
+    private static void NormalizeBounds(ReadOnlySpan<T> lowerBounds, ReadOnlySpan<T> upperBounds, Span<T> lower, Span<T> upper)
+    {
+        int n = lower.Length;
+        T infinity = T.CreateChecked(double.PositiveInfinity);
+        for (int i = 0; i < n; i++)
         {
-            // Vectorizable loop for larger dimensions
-            for (int i = 0; i < parameters.Length; i++)
+            lower[i] = i < lowerBounds.Length ? lowerBounds[i] : -infinity;
+            upper[i] = i < upperBounds.Length ? upperBounds[i] : infinity;
+        }
+    }
+
+    /// <summary>
+    /// Projects x onto the box; with mirror, each coordinate is first reflected across the bound
+    /// it violates (2 lower - x exceeds x only when x is below lower) and what still lies outside
+    /// is clamped
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static void ConfineToBox(Span<T> x, ReadOnlySpan<T> lowerBounds, ReadOnlySpan<T> upperBounds, bool mirror)
+    {
+        T two = T.CreateChecked(2);
+        for (int i = 0; i < x.Length; i++)
+        {
+            T value = x[i];
+            if (mirror)
             {
-                if (i < lowerBounds.Length && parameters[i] < lowerBounds[i])
-                {
-                    T violation = lowerBounds[i] - parameters[i];
-                    penalty += PenaltyFactor * violation * violation;
-                }
-                if (i < upperBounds.Length && parameters[i] > upperBounds[i])
-                {
-                    T violation = parameters[i] - upperBounds[i];
-                    penalty += PenaltyFactor * violation * violation;
-                }
+                value = T.Max(value, two * lowerBounds[i] - value);
+                value = T.Min(value, two * upperBounds[i] - value);
             }
+            x[i] = T.Min(T.Max(value, lowerBounds[i]), upperBounds[i]);
         }
-
-        return objective(parameters) + penalty;
     }
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
@@ -355,42 +844,85 @@ public static class NelderMeadOptimized<T> where T : unmanaged, IFloatingPoint<T
         }
     }
 
+    /// <summary>
+    /// Sum of all n+1 vertices, from scratch
+    /// </summary>
+    private static void SumVertices(ReadOnlySpan<T> simplex, Span<T> vertexSum, int n)
+    {
+        vertexSum.Clear();
+        for (int i = 0; i <= n; i++)
+        {
+            var vertex = simplex.Slice(i * n, n);
+            for (int j = 0; j < n; j++)
+                vertexSum[j] += vertex[j];
+        }
+    }
+
+    /// <summary>
+    /// Overwrites the worst vertex with point and keeps the running vertex sum in step; every
+    /// n + 1 replacements it schedules the next simplex extent test when trackExtent is set
+    /// </summary>
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    private static void CalculateCentroidOptimized(Span<T> simplex, Span<int> indices, Span<T> centroid, int excludeIndex, int n)
+    private static void ReplaceWorst(OptimizationWorkspace workspace, Span<T> worstVertex, ReadOnlySpan<T> point, ref int replacements, ref bool extentDue, bool trackExtent)
     {
-        centroid.Clear();
-        
-        // Optimized centroid calculation with potential for vectorization
-        if (n <= 6)
+        var vertexSum = workspace.VertexSum.AsSpan(0, worstVertex.Length);
+        for (int j = 0; j < worstVertex.Length; j++)
         {
-            // Unrolled loop for small dimensions
-            for (int i = 0; i <= n; i++)
-            {
-                if (indices[i] == excludeIndex) continue;
-                
-                var vertex = simplex.Slice(indices[i] * n, n);
-                for (int j = 0; j < n; j++)
-                    centroid[j] += vertex[j];
-            }
+            vertexSum[j] += point[j] - worstVertex[j];
+            worstVertex[j] = point[j];
         }
-        else
+
+        if (++replacements == CentroidRefreshInterval)
         {
-            // Vectorizable loop for larger dimensions
-            for (int i = 0; i <= n; i++)
+            SumVertices(workspace.Simplex, vertexSum, worstVertex.Length);
+            replacements = 0;
+        }
+        if (replacements % (worstVertex.Length + 1) == 0) extentDue = trackExtent;
+    }
+
+    /// <summary>
+    /// NLopt's relstop: newValue is within the absolute or the relative tolerance of oldValue, the
+    /// latter scaled by the mean of their magnitudes. An infinite oldValue is never within tolerance.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static bool Within(T oldValue, T newValue, T absolute, T relative)
+    {
+        if (T.IsInfinity(oldValue)) return false;
+        T change = oldValue - newValue;
+        return change <= absolute || change <= relative * (T.Abs(oldValue) + T.Abs(newValue)) * Half;
+    }
+
+    /// <summary>
+    /// True when, along every coordinate, the largest and smallest vertex coordinates are within
+    /// the parameter tolerances of each other. The scan is O(n^2), so the solver runs it every
+    /// n + 1 replacements and after shrinks and restarts: O(n) per iteration amortized, at the
+    /// price of noticing parameter convergence up to n iterations late.
+    /// </summary>
+    private static bool ExtentWithin(ReadOnlySpan<T> simplex, int n, T absolute, T relative)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            T lower = simplex[j];
+            T upper = simplex[j];
+            for (int i = 1; i <= n; i++)
             {
-                if (indices[i] == excludeIndex) continue;
-                
-                var vertex = simplex.Slice(indices[i] * n, n);
-                for (int j = 0; j < n; j++)
-                    centroid[j] += vertex[j];
+                lower = T.Min(lower, simplex[i * n + j]);
+                upper = T.Max(upper, simplex[i * n + j]);
             }
+            if (!Within(upper, lower, absolute, relative)) return false;
         }
-        
+        return true;
+    }
+
+    /// <summary>
+    /// Centroid of every vertex but the worst, in O(n) from the running vertex sum
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static void CalculateCentroidOptimized(ReadOnlySpan<T> vertexSum, ReadOnlySpan<T> worstVertex, Span<T> centroid, int n)
+    {
         T divisor = T.CreateChecked(n);
-        
-        // Potential for SIMD vectorization
-        for (int i = 0; i < n; i++)
-            centroid[i] /= divisor;
+        for (int j = 0; j < n; j++)
+            centroid[j] = (vertexSum[j] - worstVertex[j]) / divisor;
     }
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
@@ -402,23 +934,23 @@ public static class NelderMeadOptimized<T> where T : unmanaged, IFloatingPoint<T
     }
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    private static void ExpandOptimized(ReadOnlySpan<T> centroid, ReadOnlySpan<T> reflected, Span<T> expanded)
+    private static void ExpandOptimized(ReadOnlySpan<T> centroid, ReadOnlySpan<T> reflected, Span<T> expanded, T gamma)
     {
         // Vectorizable operation: expanded = centroid + gamma * (reflected - centroid)
         for (int i = 0; i < expanded.Length; i++)
-            expanded[i] = centroid[i] + Gamma * (reflected[i] - centroid[i]);
+            expanded[i] = centroid[i] + gamma * (reflected[i] - centroid[i]);
     }
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    private static void ContractOptimized(ReadOnlySpan<T> centroid, ReadOnlySpan<T> point, Span<T> contracted)
+    private static void ContractOptimized(ReadOnlySpan<T> centroid, ReadOnlySpan<T> point, Span<T> contracted, T rho)
     {
         // Vectorizable operation: contracted = centroid + rho * (point - centroid)
         for (int i = 0; i < contracted.Length; i++)
-            contracted[i] = centroid[i] + Rho * (point[i] - centroid[i]);
+            contracted[i] = centroid[i] + rho * (point[i] - centroid[i]);
     }
 
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
-    private static void ShrinkSimplexOptimized(Span<T> simplex, Span<int> indices, int bestIndex, int n)
+    private static void ShrinkSimplexOptimized(Span<T> simplex, Span<int> indices, int bestIndex, int n, T sigma)
     {
         var bestVertex = simplex.Slice(bestIndex * n, n);
         
@@ -427,7 +959,7 @@ public static class NelderMeadOptimized<T> where T : unmanaged, IFloatingPoint<T
         {
             var vertex = simplex.Slice(indices[i] * n, n);
             for (int j = 0; j < n; j++)
-                vertex[j] = bestVertex[j] + Sigma * (vertex[j] - bestVertex[j]);
+                vertex[j] = bestVertex[j] + sigma * (vertex[j] - bestVertex[j]);
         }
     }
 }
\ No newline at end of file
@@ -10,6 +10,7 @@ public readonly struct OptimizationResult<T> where T : IFloatingPoint<T>
     public int FunctionEvaluations { get; init; }
     public bool Converged { get; init; }
     public string? Message { get; init; }
+    public int Restarts { get; init; }
 
     public OptimizationResult(
         ReadOnlyMemory<T> optimalParameters,
@@ -0,0 +1,171 @@
+using System.Diagnostics;
+using System.Globalization;
+
+namespace Optimization.Core.Algorithms;
+
+/// <summary>
+/// Nelder-Mead operation an iteration ended in. Evaluations are attributed to it:
+/// Reflect = 1, Expand = 2, ContractOutside/ContractInside = 2, Shrink = 2 + n, Restart = n.
+/// </summary>
+public enum NelderMeadOperation
+{
+    Initialize,
+    Reflect,
+    Expand,
+    ContractOutside,
+    ContractInside,
+    Shrink,
+    Restart
+}
+
+public enum SolverPhase
+{
+    Sort,
+    Centroid,
+    Objective
+}
+
+/// <summary>
+/// Telemetry hooks called by the solvers. Implement on a struct to let the JIT
+/// specialize the solver; NullSolverTrace compiles away entirely.
+/// </summary>
+public interface ISolverTrace
+{
+    bool Enabled { get; }
+    void Begin(int dimension);
+    long Clock();
+    void Phase(SolverPhase phase, long started);
+    void Operation(NelderMeadOperation operation, int evaluations);
+    void Best(int iteration, int evaluations, double value);
+
+    /// <summary>One lookup in the evaluation cache; hits are still counted as evaluations</summary>
+    void Cache(bool hit);
+
+    void End(int iterations);
+}
+
+public readonly struct NullSolverTrace : ISolverTrace
+{
+    public bool Enabled => false;
+    public void Begin(int dimension) { }
+    public long Clock() => 0;
+    public void Phase(SolverPhase phase, long started) { }
+    public void Operation(NelderMeadOperation operation, int evaluations) { }
+    public void Best(int iteration, int evaluations, double value) { }
+    public void Cache(bool hit) { }
+    public void End(int iterations) { }
+}
+
+/// <summary>
+/// Counts operations and their evaluations, times sorting, centroid and objective,
+/// and keeps the best-value history. Output matches Benchmarks/SolverTrace.hpp.
+/// </summary>
+public sealed class SolverTrace : ISolverTrace
+{
+    private static readonly int OperationCount = Enum.GetValues<NelderMeadOperation>().Length;
+    private static readonly int PhaseCount = Enum.GetValues<SolverPhase>().Length;
+
+    private readonly long[] _operationCounts = new long[OperationCount];
+    private readonly long[] _operationEvaluations = new long[OperationCount];
+    private readonly long[] _phaseTicks = new long[PhaseCount];
+    private readonly List<(int Iteration, int Evaluations, double BestValue)> _history = new();
+    private long _startTicks;
+    private long _totalTicks;
+
+    public int Dimension { get; private set; }
+    public int Iterations { get; private set; }
+    public long Evaluations { get; private set; }
+    public long CacheHits { get; private set; }
+    public long CacheMisses { get; private set; }
+    public IReadOnlyList<(int Iteration, int Evaluations, double BestValue)> History => _history;
+    public double TotalMilliseconds => TicksToMilliseconds(_totalTicks);
+
+    /// <summary>Time outside the timed phases: simplex updates, bounds, bookkeeping</summary>
+    public double OtherMilliseconds => TicksToMilliseconds(_totalTicks - _phaseTicks.Sum());
+
+    public bool Enabled => true;
+
+    public void Begin(int dimension)
+    {
+        Dimension = dimension;
+        Iterations = 0;
+        Evaluations = 0;
+        Array.Clear(_operationCounts);
+        Array.Clear(_operationEvaluations);
+        Array.Clear(_phaseTicks);
+        _history.Clear();
+        CacheHits = 0;
+        CacheMisses = 0;
+        _startTicks = Stopwatch.GetTimestamp();
+        _totalTicks = 0;
+    }
+
+    public long Clock() => Stopwatch.GetTimestamp();
+
+    public void Phase(SolverPhase phase, long started) => _phaseTicks[(int)phase] += Stopwatch.GetTimestamp() - started;
+
+    public void Operation(NelderMeadOperation operation, int evaluations)
+    {
+        _operationCounts[(int)operation]++;
+        _operationEvaluations[(int)operation] += evaluations;
+        Evaluations += evaluations;
+    }
+
+    /// <summary>Records a point only when the best value improves</summary>
+    public void Best(int iteration, int evaluations, double value)
+    {
+        if (_history.Count == 0 || value < _history[^1].BestValue)
+            _history.Add((iteration, evaluations, value));
+    }
+
+    public void Cache(bool hit)
+    {
+        if (hit) CacheHits++;
+        else CacheMisses++;
+    }
+
+    public void End(int iterations)
+    {
+        Iterations = iterations;
+        _totalTicks = Stopwatch.GetTimestamp() - _startTicks;
+    }
+
+    public long OperationCountOf(NelderMeadOperation operation) => _operationCounts[(int)operation];
+    public long OperationEvaluationsOf(NelderMeadOperation operation) => _operationEvaluations[(int)operation];
+    public double PhaseMilliseconds(SolverPhase phase) => TicksToMilliseconds(_phaseTicks[(int)phase]);
+
+    public static void WriteCsvHeader(TextWriter writer) =>
+        writer.WriteLine("TestName,Record,Name,Count,Evaluations,Time_ms");
+
+    /// <summary>One row per operation and per phase, then the cache hits and misses</summary>
+    public void WriteCsv(TextWriter writer, string label)
+    {
+        foreach (var operation in Enum.GetValues<NelderMeadOperation>())
+            writer.WriteLine($"{label},operation,{operation},{OperationCountOf(operation)},{OperationEvaluationsOf(operation)},");
+        foreach (var phase in Enum.GetValues<SolverPhase>())
+            writer.WriteLine(FormattableString.Invariant($"{label},phase,{phase},,,{PhaseMilliseconds(phase)}"));
+        writer.WriteLine(FormattableString.Invariant($"{label},phase,Other,,,{OtherMilliseconds}"));
+        writer.WriteLine($"{label},cache,Hits,{CacheHits},,");
+        writer.WriteLine($"{label},cache,Misses,{CacheMisses},,");
+    }
+
+    public void WriteJson(TextWriter writer, string label)
+    {
+        var culture = CultureInfo.InvariantCulture;
+        var operations = Enum.GetValues<NelderMeadOperation>().Select(operation =>
+            $"\"{operation}\": {{\"count\": {OperationCountOf(operation)}, \"evaluations\": {OperationEvaluationsOf(operation)}}}");
+        var phases = Enum.GetValues<SolverPhase>().Select(phase =>
+            $"\"{phase}\": {PhaseMilliseconds(phase).ToString("R", culture)}");
+        var history = _history.Select(point =>
+            $"[{point.Iteration}, {point.Evaluations}, {point.BestValue.ToString("R", culture)}]");
+
+        writer.Write($"{{\"test\": \"{label}\", \"dimension\": {Dimension}, \"iterations\": {Iterations}, ");
+        writer.Write($"\"evaluations\": {Evaluations}, \"total_ms\": {TotalMilliseconds.ToString("R", culture)}, ");
+        writer.Write($"\"operations\": {{{string.Join(", ", operations)}}}, ");
+        writer.Write($"\"phases_ms\": {{{string.Join(", ", phases)}, \"Other\": {OtherMilliseconds.ToString("R", culture)}}}, ");
+        writer.Write($"\"cache\": {{\"hits\": {CacheHits}, \"misses\": {CacheMisses}}}, ");
+        writer.Write($"\"history\": [{string.Join(", ", history)}]}}");
+    }
+
+    private static double TicksToMilliseconds(long ticks) => ticks * 1000.0 / Stopwatch.Frequency;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+// One entry of the batch output array, shared by the CPU (BatchFitter.hpp)
+// and GPU (GpuBatchFitter.hpp) batch drivers. Kept free of the solver
+// headers so GPU device code can write it directly.
+struct BatchFitResult {
+    static constexpr size_t ParameterCount = 6;
+
+    double parameters[ParameterCount];
+    double final_value;
+    int function_evaluations;
+    int iterations;
+    bool converged;
+    bool warm_started;     // seeded from a previous fit's solution
+};
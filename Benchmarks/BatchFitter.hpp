@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "BatchFitResult.hpp"
+#include "DatasetFile.hpp"
+#include "DoubleGaussian.hpp"
+#include "NelderMead.hpp"
+#include "ResultSink.hpp"
+#include "ThreadPool.hpp"
+#include "WarmStart.hpp"
+
+static_assert(PackedFitResult::ParameterCount == DoubleGaussianData::ParameterCount,
+              "Packed results hold one Double Gaussian parameter set");
+static_assert(BatchFitResult::ParameterCount == DoubleGaussianData::ParameterCount,
+              "Batch results hold one Double Gaussian parameter set");
+
+// Fits many independent Double Gaussian datasets across all cores. Each pool
+// worker owns a NelderMead solver specialized for the six parameters, whose
+// simplex lives inline in the solver and is reused for every fit that thread
+// picks up. With options.cache_size set, the solver's evaluation cache comes
+// from its own arena, reset at the start of each fit, so after a worker's
+// first fit the fits themselves do not touch the heap.
+//
+// With warm starts enabled, each worker also remembers its last few converged
+// fits (WarmStart.hpp) and seeds a fit from the nearest one's solution with a
+// smaller initial simplex, falling back to the caller's guess when nothing is
+// similar. Caches persist across fit() calls, so a stream fed in chunks keeps
+// its history. Which fits a worker has seen depends on scheduling, so warm
+// started batches are only reproducible with a single thread.
+class BatchFitter {
+public:
+    explicit BatchFitter(size_t threads = 0)
+        : pool_(threads),
+          solvers_(pool_.size()) {}
+
+    size_t thread_count() const { return pool_.size(); }
+
+    void set_warm_start(const WarmStartOptions& options) {
+        warm_start_ = options;
+        caches_.assign(pool_.size(), WarmStartCache<DoubleGaussianData::ParameterCount>(options.capacity));
+    }
+
+    const WarmStartOptions& warm_start() const { return warm_start_; }
+
+    // Forgets every remembered fit
+    void reset_warm_start() {
+        for (auto& cache : caches_) cache.clear();
+    }
+
+    // datasets[i] is fitted from initial_guesses[i * 6 .. i * 6 + 6) into
+    // results[i]. Both arrays are caller-owned and must hold count entries.
+    void fit(const DoubleGaussianData* datasets,
+             const double* initial_guesses,
+             size_t count,
+             BatchFitResult* results,
+             const NelderMeadOptions<double>& options = NelderMeadOptions<double>()) {
+        const size_t n = DoubleGaussianData::ParameterCount;
+        const NelderMeadOptions<double> warm = warm_options(options);
+        pool_.parallel_for(count, [&](size_t i, size_t worker) {
+            fit_one(worker, const_cast<DoubleGaussianData*>(&datasets[i]),
+                    initial_guesses + i * n, results[i], options, warm);
+        });
+    }
+
+    // Fits every record of a mapped file in place: each worker wraps the
+    // record in a view on its own stack, so samples are never copied and
+    // initial_guesses/results are indexed by record as above.
+    void fit(const MappedDatasetFile<double>& file,
+             const double* initial_guesses,
+             BatchFitResult* results,
+             const NelderMeadOptions<double>& options = NelderMeadOptions<double>()) {
+        const size_t n = DoubleGaussianData::ParameterCount;
+        const NelderMeadOptions<double> warm = warm_options(options);
+        pool_.parallel_for(file.size(), [&](size_t i, size_t worker) {
+            DoubleGaussianData spectrum(file.record(i));
+            fit_one(worker, &spectrum, initial_guesses + i * n, results[i], options, warm);
+        });
+    }
+
+    // Same, streaming each result to sink as it completes instead of into an
+    // array, for batches whose results do not fit comfortably in memory
+    void fit(const MappedDatasetFile<double>& file,
+             const double* initial_guesses,
+             ResultSink& sink,
+             const NelderMeadOptions<double>& options = NelderMeadOptions<double>()) {
+        const size_t n = DoubleGaussianData::ParameterCount;
+        const NelderMeadOptions<double> warm = warm_options(options);
+        pool_.parallel_for(file.size(), [&](size_t i, size_t worker) {
+            DoubleGaussianData spectrum(file.record(i));
+            BatchFitResult fit;
+            fit_one(worker, &spectrum, initial_guesses + i * n, fit, options, warm);
+
+            PackedFitResult packed;
+            packed.record = i;
+            std::copy(fit.parameters, fit.parameters + n, packed.parameters);
+            packed.final_value = fit.final_value;
+            packed.function_evaluations = fit.function_evaluations;
+            packed.iterations = fit.iterations;
+            packed.flags = (fit.converged ? PackedFitResult::ConvergedFlag : 0) |
+                           (fit.warm_started ? PackedFitResult::WarmStartedFlag : 0);
+            packed.reserved = 0;
+            sink.push(packed);
+        });
+    }
+
+private:
+    // The caller's options with the warm-start simplex size; unused (and not
+    // copied) when warm starts are off
+    NelderMeadOptions<double> warm_options(const NelderMeadOptions<double>& options) const {
+        NelderMeadOptions<double> warm;
+        if (warm_start_.enabled) {
+            warm = options;
+            warm.initial_simplex_size = warm_start_.simplex_size;
+        }
+        return warm;
+    }
+
+    void fit_one(size_t worker, DoubleGaussianData* spectrum, const double* initial_guess,
+                 BatchFitResult& out, const NelderMeadOptions<double>& options,
+                 const NelderMeadOptions<double>& warm_options) {
+        const double* guess = initial_guess;
+        const NelderMeadOptions<double>* fit_options = &options;
+        SpectrumSignature signature;
+        if (warm_start_.enabled) {
+            signature = SpectrumSignature::of(spectrum->data);
+            if (const double* cached = caches_[worker].lookup(signature, warm_start_.max_distance)) {
+                guess = cached;
+                fit_options = &warm_options;
+            }
+        }
+
+        BoundObjective<double, DoubleGaussianData::objective> objective{spectrum, DoubleGaussianData::ParameterCount};
+        OptimizationResult<double> r = solvers_[worker].minimize(
+            objective, guess, DoubleGaussianData::ParameterCount, out.parameters, *fit_options);
+        out.final_value = r.optimal_value;
+        out.function_evaluations = r.function_evaluations;
+        out.iterations = r.iterations;
+        out.converged = r.converged;
+        out.warm_started = guess != initial_guess;
+
+        if (warm_start_.enabled && r.converged) caches_[worker].insert(signature, out.parameters);
+    }
+
+    ThreadPool pool_;
+    std::vector<NelderMead<double, DoubleGaussianData::ParameterCount>> solvers_;
+    WarmStartOptions warm_start_;
+    std::vector<WarmStartCache<DoubleGaussianData::ParameterCount>> caches_;
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "PerfCounters.hpp"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Shared timing core for the C++ benchmarks.
+//
+// A measurement runs a few untimed warmup runs, then uses the last one to
+// calibrate how many runs to batch into each sample (so a sample is well
+// above clock resolution) and how many samples to take (so the whole
+// measurement lasts about target_time_ms). Reported statistics are order
+// statistics over the per-run times of the samples: min, median, p90, p99,
+// and a distribution-free 95% confidence interval for the median.
+//
+// Cycles are read from the TSC on x86, which counts at a constant reference
+// rate rather than the current core clock; elsewhere cycles are reported as 0.
+// With perf_counters set, hardware counters (PerfCounters.hpp) cover the
+// sampled runs only, not the warmup, and are reported per run. They count
+// the measuring thread alone: work a run hands to other threads is not
+// included, so callers turn them off for multi-threaded runs.
+
+struct BenchmarkConfig {
+    int warmup_runs = 3;
+    double target_time_ms = 200.0;      // total time to spend sampling
+    double min_sample_time_ms = 0.05;   // runs are batched until a sample is this long
+    size_t min_samples = 10;
+    size_t max_samples = 1000;
+    int cpu = -1;                       // pin the measuring thread to this CPU; -1 = no pinning
+    bool perf_counters = false;         // record hardware counters where the kernel allows
+};
+
+struct BenchmarkStats {
+    size_t samples = 0;
+    size_t runs_per_sample = 0;
+    double min_ms = 0.0;
+    double median_ms = 0.0;
+    double p90_ms = 0.0;
+    double p99_ms = 0.0;
+    double median_ci_low_ms = 0.0;      // 95% confidence interval of the median
+    double median_ci_high_ms = 0.0;
+    double cycles_per_run = 0.0;        // median
+    double cycles_per_evaluation = 0.0; // cycles_per_run / evaluations of one run
+    PerfCounterValues counters;         // per run; empty unless perf_counters was set
+    std::vector<double> sample_ms;      // per-run time of every sample, sorted
+};
+
+// Pins the calling thread to one CPU for its lifetime and restores the
+// previous affinity afterwards. Threads started while it is active inherit
+// the single-CPU mask, so create worker pools before pinning.
+class ScopedCpuPin {
+public:
+    explicit ScopedCpuPin(int cpu) {
+#if defined(__linux__)
+        if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+        if (sched_getaffinity(0, sizeof(previous_), &previous_) != 0) return;
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpu, &mask);
+        active_ = sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#else
+        (void)cpu;
+#endif
+    }
+
+    ~ScopedCpuPin() {
+#if defined(__linux__)
+        if (active_) sched_setaffinity(0, sizeof(previous_), &previous_);
+#endif
+    }
+
+    ScopedCpuPin(const ScopedCpuPin&) = delete;
+    ScopedCpuPin& operator=(const ScopedCpuPin&) = delete;
+
+    bool active() const { return active_; }
+
+private:
+    bool active_ = false;
+#if defined(__linux__)
+    cpu_set_t previous_;
+#endif
+};
+
+class BenchmarkRunner {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit BenchmarkRunner(const BenchmarkConfig& config = BenchmarkConfig()) : config_(config) {}
+
+    const BenchmarkConfig& config() const { return config_; }
+
+    static uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    // Times run(), which performs one complete run from a fresh start and
+    // returns the number of function evaluations it made.
+    template<typename F>
+    BenchmarkStats measure(F&& run) const {
+        return measure(run, config_);
+    }
+
+    template<typename F>
+    static BenchmarkStats measure(F&& run, const BenchmarkConfig& config) {
+        ScopedCpuPin pin(config.cpu);
+
+        // Warmup; the last warmup run calibrates the batch size
+        double single_ms = 0.0;
+        int warmups = std::max(config.warmup_runs, 1);
+        for (int i = 0; i < warmups; i++) {
+            auto start = Clock::now();
+            run();
+            single_ms = elapsed_ms(start, Clock::now());
+        }
+
+        size_t runs_per_sample = 1;
+        if (single_ms < config.min_sample_time_ms)
+            runs_per_sample = static_cast<size_t>(std::ceil(config.min_sample_time_ms / std::max(single_ms, 1e-6)));
+        double sample_ms = std::max(single_ms, 1e-6) * runs_per_sample;
+        size_t sample_count = static_cast<size_t>(config.target_time_ms / sample_ms);
+        sample_count = std::min(std::max(sample_count, config.min_samples), config.max_samples);
+
+        std::vector<double> times(sample_count);
+        std::vector<double> cycles(sample_count);
+        long evaluations = 0;
+        std::unique_ptr<PerfCounters> pmu;
+        if (config.perf_counters) {
+            pmu.reset(new PerfCounters());
+            pmu->start();
+        }
+        for (size_t s = 0; s < sample_count; s++) {
+            uint64_t cycles_start = read_cycles();
+            auto start = Clock::now();
+            for (size_t r = 0; r < runs_per_sample; r++) evaluations = run();
+            auto end = Clock::now();
+            uint64_t cycles_end = read_cycles();
+            times[s] = elapsed_ms(start, end) / runs_per_sample;
+            cycles[s] = double(cycles_end - cycles_start) / runs_per_sample;
+        }
+
+        BenchmarkStats stats;
+        if (pmu) stats.counters = pmu->stop(sample_count * runs_per_sample);
+        stats.samples = sample_count;
+        stats.runs_per_sample = runs_per_sample;
+        std::sort(times.begin(), times.end());
+        std::sort(cycles.begin(), cycles.end());
+        stats.sample_ms = times;
+        stats.min_ms = times.front();
+        stats.median_ms = median(times);
+        stats.p90_ms = percentile(times, 0.90);
+        stats.p99_ms = percentile(times, 0.99);
+
+        // Ranks n/2 -+ 1.96 sqrt(n)/2 bound the median with ~95% confidence
+        // for any distribution (normal approximation to the binomial)
+        double n = double(sample_count);
+        double half_width = 0.98 * std::sqrt(n);
+        long low = static_cast<long>(std::floor(n / 2.0 - half_width));
+        long high = static_cast<long>(std::ceil(n / 2.0 + half_width));
+        stats.median_ci_low_ms = times[std::max(low, 1L) - 1];
+        stats.median_ci_high_ms = times[std::min<long>(high, sample_count) - 1];
+
+        stats.cycles_per_run = median(cycles);
+        stats.cycles_per_evaluation = evaluations > 0 ? stats.cycles_per_run / evaluations : 0.0;
+        return stats;
+    }
+
+private:
+    BenchmarkConfig config_;
+
+    static double elapsed_ms(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Inputs are sorted
+    static double median(const std::vector<double>& v) {
+        size_t n = v.size();
+        return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+    }
+
+    // Nearest-rank percentile
+    static double percentile(const std::vector<double>& v, double q) {
+        size_t rank = static_cast<size_t>(std::ceil(q * v.size()));
+        return v[std::min(std::max<size_t>(rank, 1), v.size()) - 1];
+    }
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <thread>
+
+// Identifies the build and machine a set of benchmark results came from, so
+// results are only compared against baselines from a comparable setup. The
+// Makefile passes the compiler flags and git revision in with -D; a build
+// outside it reports them as "unknown".
+#ifndef BENCHMARK_CXXFLAGS
+#define BENCHMARK_CXXFLAGS "unknown"
+#endif
+
+#ifndef BENCHMARK_GIT_REVISION
+#define BENCHMARK_GIT_REVISION "unknown"
+#endif
+
+struct BuildInfo {
+    static const char* cxxflags() { return BENCHMARK_CXXFLAGS; }
+    static const char* git_revision() { return BENCHMARK_GIT_REVISION; }
+
+    static const char* compiler() {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#else
+        return "unknown";
+#endif
+    }
+
+    // First "model name" of /proc/cpuinfo; "unknown" where there is none
+    static std::string cpu_model() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 10, "model name") != 0) continue;
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) break;
+            size_t start = line.find_first_not_of(' ', colon + 1);
+            return start == std::string::npos ? std::string() : line.substr(start);
+        }
+        return "unknown";
+    }
+
+    static unsigned hardware_threads() { return std::thread::hardware_concurrency(); }
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+// Structure-of-arrays container for fitting data.
+//
+// x, y and (optionally) weight live in separate 64-byte aligned arrays whose
+// length is rounded up to a whole cache line (8 doubles / 16 floats), which is
+// also a whole number of SIMD vectors for every kernel path. Padding samples
+// hold x = +inf, y = 0, weight = 0, so they contribute exactly zero to the
+// SSR for any finite parameters and kernels can run over padded_size() without
+// a remainder loop.
+//
+// A Dataset either owns one aligned block holding all three arrays, or is a
+// non-owning view over caller buffers. Views never copy; whether they can be
+// processed without a tail depends on the caller's padding (see view()).
+template<typename T>
+class Dataset {
+public:
+    static constexpr size_t Alignment = 64;
+    static constexpr size_t PaddingMultiple = Alignment / sizeof(T);
+
+    Dataset() = default;
+
+    // Owning dataset of count samples, padded and zero-weighted in the tail.
+    // Weights are only stored when weighted is true; otherwise every sample
+    // has implicit weight 1.
+    explicit Dataset(size_t count, bool weighted = false)
+        : size_(count), padded_size_(round_up(count)), owns_(true) {
+        size_t arrays = weighted ? 3 : 2;
+        size_t bytes = arrays * padded_size_ * sizeof(T);
+        if (bytes == 0) return;
+        T* block = static_cast<T*>(std::aligned_alloc(Alignment, bytes));
+        if (block == nullptr) throw std::bad_alloc();
+        x_ = block;
+        y_ = block + padded_size_;
+        w_ = weighted ? block + 2 * padded_size_ : nullptr;
+        std::fill(x_ + size_, x_ + padded_size_, std::numeric_limits<T>::infinity());
+        std::fill(y_ + size_, y_ + padded_size_, T(0));
+        if (w_) {
+            std::fill(w_, w_ + size_, T(1));
+            std::fill(w_ + size_, w_ + padded_size_, T(0));
+        }
+    }
+
+    // Non-owning view over existing buffers (weights may be null). Pass
+    // padded_count > count only if the buffers really extend that far with
+    // the padding contract above (x = +inf, y = 0, weight = 0); otherwise
+    // kernels fall back to a scalar tail for the last few samples.
+    static Dataset view(const T* x, const T* y, const T* weights, size_t count, size_t padded_count = 0) {
+        Dataset d;
+        d.x_ = const_cast<T*>(x);
+        d.y_ = const_cast<T*>(y);
+        d.w_ = const_cast<T*>(weights);
+        d.size_ = count;
+        d.padded_size_ = std::max(count, padded_count);
+        d.owns_ = false;
+        return d;
+    }
+
+    Dataset(const Dataset& other) { copy_from(other); }
+    Dataset(Dataset&& other) noexcept { steal(other); }
+
+    Dataset& operator=(const Dataset& other) {
+        if (this != &other) {
+            release();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    Dataset& operator=(Dataset&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~Dataset() { release(); }
+
+    size_t size() const { return size_; }
+    size_t padded_size() const { return padded_size_; }
+    bool owns_data() const { return owns_; }
+    bool weighted() const { return w_ != nullptr; }
+
+    const T* x() const { return x_; }
+    const T* y() const { return y_; }
+    const T* weights() const { return w_; }
+
+    // Writable access, owning datasets only
+    T* x() { return writable(x_); }
+    T* y() { return writable(y_); }
+    T* weights() { return writable(w_); }
+
+    void set(size_t i, T x, T y) {
+        writable(x_)[i] = x;
+        y_[i] = y;
+    }
+
+    void set(size_t i, T x, T y, T w) {
+        set(i, x, y);
+        if (w_) w_[i] = w;
+    }
+
+    static size_t round_up(size_t count) {
+        return (count + PaddingMultiple - 1) / PaddingMultiple * PaddingMultiple;
+    }
+
+private:
+    T* x_ = nullptr;
+    T* y_ = nullptr;
+    T* w_ = nullptr;
+    size_t size_ = 0;
+    size_t padded_size_ = 0;
+    bool owns_ = false;
+
+    T* writable(T* p) {
+        if (!owns_) throw std::logic_error("Dataset view is read-only");
+        return p;
+    }
+
+    void release() {
+        if (owns_) std::free(x_);
+        x_ = y_ = w_ = nullptr;
+        size_ = padded_size_ = 0;
+        owns_ = false;
+    }
+
+    void copy_from(const Dataset& other) {
+        if (!other.owns_) {
+            x_ = other.x_;
+            y_ = other.y_;
+            w_ = other.w_;
+            size_ = other.size_;
+            padded_size_ = other.padded_size_;
+            owns_ = false;
+            return;
+        }
+        Dataset copy(other.size_, other.weighted());
+        size_t arrays = other.weighted() ? 3 : 2;
+        if (copy.x_) std::memcpy(copy.x_, other.x_, arrays * other.padded_size_ * sizeof(T));
+        steal(copy);
+    }
+
+    void steal(Dataset& other) {
+        x_ = other.x_;
+        y_ = other.y_;
+        w_ = other.w_;
+        size_ = other.size_;
+        padded_size_ = other.padded_size_;
+        owns_ = other.owns_;
+        other.x_ = other.y_ = other.w_ = nullptr;
+        other.size_ = other.padded_size_ = 0;
+        other.owns_ = false;
+    }
+};
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Dataset.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Columnar binary file of many datasets, memory-mapped for fitting without
+// parsing or copying.
+//
+// Layout (native byte order, every offset a multiple of 64 bytes):
+//
+//   header    64 bytes   DatasetFileHeader
+//   records   ...        per record: x, y and, if weighted, weight arrays of
+//                        padded_count samples each, back to back
+//   index     ...        record_count DatasetFileIndexEntry, at index_offset
+//
+// padded_count is count rounded up to Dataset<S>::PaddingMultiple and the
+// padding samples follow the Dataset contract (x = +inf, y = 0, weight = 0),
+// so every record maps straight to a Dataset view that kernels process
+// without a tail. The index gives random access to any record.
+//
+// Records are mapped as written, so a file only reads on hosts of the byte
+// order that wrote it; the magic reads byte-swapped on the others and the
+// mapping is rejected. The magic is only written by finish(), so a file
+// whose writer never finished is rejected too.
+
+struct DatasetFileHeader {
+    static constexpr uint32_t Magic = 0x53444744;   // "DGDS"
+    static constexpr uint32_t SwappedMagic = 0x44474453;   // Magic written in the other byte order
+    static constexpr uint32_t Version = 1;
+    static constexpr uint32_t WeightedFlag = 1;
+
+    uint32_t magic = Magic;
+    uint32_t version = Version;
+    uint32_t sample_bytes = 0;     // 8 = double, 4 = float
+    uint32_t flags = 0;
+    uint64_t record_count = 0;
+    uint64_t index_offset = 0;
+    uint8_t reserved[32] = {};
+};
+
+struct DatasetFileIndexEntry {
+    uint64_t offset;          // byte offset of the record's x array
+    uint64_t count;           // samples, excluding padding
+};
+
+static_assert(sizeof(DatasetFileHeader) == 64, "Header must fill one cache line");
+static_assert(sizeof(DatasetFileIndexEntry) == 16, "Index entries are two 64-bit words");
+
+// Appends records and writes the index and the header on finish(), which
+// must be called explicitly. A writer destroyed without it (an exception
+// out of append(), say) leaves an unfinished file that readers reject.
+template<typename S>
+class DatasetFileWriter {
+public:
+    explicit DatasetFileWriter(const std::string& path, bool weighted = false)
+        : out_(path, std::ios::binary | std::ios::trunc), weighted_(weighted) {
+        if (!out_) throw std::runtime_error("Cannot create dataset file " + path);
+        // Placeholder without the magic until finish() writes the real header
+        DatasetFileHeader header;
+        header.magic = 0;
+        write(&header, sizeof(header));
+    }
+
+    DatasetFileWriter(const DatasetFileWriter&) = delete;
+    DatasetFileWriter& operator=(const DatasetFileWriter&) = delete;
+
+    // weights is ignored for unweighted files and may be null otherwise
+    // (every sample weight 1)
+    void append(const S* x, const S* y, const S* weights, size_t count) {
+        size_t padded = Dataset<S>::round_up(count);
+        index_.push_back({position_, count});
+        write_column(x, count, padded, std::numeric_limits<S>::infinity(), S(0));
+        write_column(y, count, padded, S(0), S(0));
+        if (weighted_) write_column(weights, count, padded, S(0), S(1));
+    }
+
+    void append(const Dataset<S>& data) { append(data.x(), data.y(), data.weights(), data.size()); }
+
+    void finish() {
+        DatasetFileHeader header;
+        header.sample_bytes = sizeof(S);
+        header.flags = weighted_ ? DatasetFileHeader::WeightedFlag : 0;
+        header.record_count = index_.size();
+        header.index_offset = position_;
+        if (!index_.empty()) write(index_.data(), index_.size() * sizeof(DatasetFileIndexEntry));
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.close();
+        if (!out_) throw std::runtime_error("Writing dataset file failed");
+    }
+
+private:
+    std::ofstream out_;
+    bool weighted_;
+    uint64_t position_ = 0;
+    std::vector<DatasetFileIndexEntry> index_;
+
+    void write(const void* data, size_t bytes) {
+        out_.write(static_cast<const char*>(data), bytes);
+        position_ += bytes;
+    }
+
+    // count values (or fill_missing when values is null), then the padding;
+    // padded * sizeof(S) is a multiple of 64, so the next column stays aligned
+    void write_column(const S* values, size_t count, size_t padded, S padding, S fill_missing) {
+        if (values) {
+            write(values, count * sizeof(S));
+        } else {
+            for (size_t i = 0; i < count; i++) write(&fill_missing, sizeof(S));
+        }
+        for (size_t i = count; i < padded; i++) write(&padding, sizeof(S));
+    }
+};
+
+// Read-only mapping of a dataset file. record(i) is a zero-copy Dataset view
+// into the mapping, valid for the lifetime of this object.
+template<typename S>
+class MappedDatasetFile {
+public:
+    explicit MappedDatasetFile(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open dataset file " + path);
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(DatasetFileHeader))) {
+            ::close(fd);
+            throw std::runtime_error("Dataset file is truncated: " + path);
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) throw std::runtime_error("Cannot map dataset file " + path);
+        base_ = static_cast<const unsigned char*>(mapping);
+#else
+        throw std::runtime_error("Memory-mapped dataset files need a POSIX system");
+#endif
+        try {
+            validate(path);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    ~MappedDatasetFile() { unmap(); }
+
+    MappedDatasetFile(const MappedDatasetFile&) = delete;
+    MappedDatasetFile& operator=(const MappedDatasetFile&) = delete;
+
+    size_t size() const { return static_cast<size_t>(header().record_count); }
+    bool weighted() const { return (header().flags & DatasetFileHeader::WeightedFlag) != 0; }
+    size_t count(size_t record) const { return static_cast<size_t>(index()[record].count); }
+
+    Dataset<S> record(size_t i) const {
+        const DatasetFileIndexEntry& entry = index()[i];
+        size_t count = static_cast<size_t>(entry.count);
+        size_t padded = Dataset<S>::round_up(count);
+        const S* x = reinterpret_cast<const S*>(base_ + entry.offset);
+        return Dataset<S>::view(x, x + padded, weighted() ? x + 2 * padded : nullptr, count, padded);
+    }
+
+    // Hints the kernel to read ahead; for passes over the whole file
+    void advise_sequential() const {
+#if defined(__unix__) || defined(__APPLE__)
+        madvise(const_cast<unsigned char*>(base_), size_, MADV_SEQUENTIAL);
+#endif
+    }
+
+private:
+    const unsigned char* base_ = nullptr;
+    size_t size_ = 0;
+
+    const DatasetFileHeader& header() const { return *reinterpret_cast<const DatasetFileHeader*>(base_); }
+
+    const DatasetFileIndexEntry* index() const {
+        return reinterpret_cast<const DatasetFileIndexEntry*>(base_ + header().index_offset);
+    }
+
+    // Checks every record lies inside the file so record() never reads past it
+    void validate(const std::string& path) const {
+        const DatasetFileHeader& h = header();
+        if (h.magic == DatasetFileHeader::SwappedMagic)
+            throw std::runtime_error("Dataset file was written with the other byte order: " + path);
+        if (h.magic != DatasetFileHeader::Magic)
+            throw std::runtime_error("Not a dataset file, or one whose writer never finished: " + path);
+        if (h.version != DatasetFileHeader::Version)
+            throw std::runtime_error("Unsupported dataset file version: " + path);
+        if (h.sample_bytes != sizeof(S))
+            throw std::runtime_error("Dataset file sample type does not match: " + path);
+        if (h.index_offset % Dataset<S>::Alignment != 0 || h.index_offset > size_ ||
+            h.record_count > (size_ - h.index_offset) / sizeof(DatasetFileIndexEntry))
+            throw std::runtime_error("Dataset file index is corrupt: " + path);
+
+        size_t columns = weighted() ? 3 : 2;
+        for (size_t i = 0; i < size(); i++) {
+            const DatasetFileIndexEntry& entry = index()[i];
+            if (entry.count > size_)
+                throw std::runtime_error("Dataset file record " + std::to_string(i) + " is corrupt: " + path);
+            uint64_t bytes = uint64_t(columns) * Dataset<S>::round_up(entry.count) * sizeof(S);
+            if (entry.offset % Dataset<S>::Alignment != 0 || entry.offset < sizeof(DatasetFileHeader) ||
+                entry.offset > h.index_offset || bytes > h.index_offset - entry.offset)
+                throw std::runtime_error("Dataset file record " + std::to_string(i) + " is corrupt: " + path);
+        }
+    }
+
+    void unmap() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (base_) munmap(const_cast<unsigned char*>(base_), size_);
+#endif
+        base_ = nullptr;
+    }
+};
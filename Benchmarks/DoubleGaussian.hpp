@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Dataset.hpp"
+#include "GaussianKernels.hpp"
+#include "ParallelReduction.hpp"
+
+// Double Gaussian fitting function over a SoA dataset. S is the storage type
+// of the samples (double, or float to halve memory per dataset); the model is
+// evaluated in double precision, except by objective_single(), the float32
+// path for float datasets.
+//
+// With a pool set, objective() splits datasets of at least parallel_min_size
+// samples into ParallelReduction chunks and sums them across the pool; the
+// result then depends on the dataset size but not on the thread count.
+// Smaller datasets, and datasets without a pool, run single-threaded. The
+// pool must not be the one calling objective() (BatchFitter,
+// ParallelNelderMead), since a pool cannot run a loop inside its own loop.
+template<typename S>
+class DoubleGaussianDataset {
+public:
+    static constexpr size_t ParameterCount = 6;
+
+    // Below this many samples waking the pool costs more than it saves
+    static constexpr size_t ParallelCrossover = 4 * ParallelReduction::ChunkSize;
+
+    Dataset<S> data;
+    ExpMode exp_mode = ExpMode::Fast;
+    ThreadPool* pool = nullptr;
+    size_t parallel_min_size = ParallelCrossover;
+
+    DoubleGaussianDataset() = default;
+    explicit DoubleGaussianDataset(Dataset<S> samples) : data(std::move(samples)) {}
+
+    size_t size() const { return data.size(); }
+
+    // Reference model evaluation (libm exp), used to generate data
+    static double evaluate(const double* params, double x) {
+        // params: [A1, mu1, sigma1, A2, mu2, sigma2]
+        double g1 = params[0] * std::exp(-0.5 * std::pow((x - params[1]) / params[2], 2));
+        double g2 = params[3] * std::exp(-0.5 * std::pow((x - params[4]) / params[5], 2));
+        return g1 + g2;
+    }
+
+    static double objective(const double* params, size_t n, void* data) {
+        DoubleGaussianDataset* dgd = static_cast<DoubleGaussianDataset*>(data);
+        if (dgd->pool == nullptr || dgd->data.size() < dgd->parallel_min_size)
+            return GaussianKernels::double_gaussian_ssr(params, dgd->data, dgd->exp_mode);
+
+        const Dataset<S>& d = dgd->data;
+        return ParallelReduction::chunked_sum(*dgd->pool, d.padded_size(), [&](size_t begin, size_t length) {
+            return GaussianKernels::double_gaussian_ssr(params, d.x() + begin, d.y() + begin,
+                                                        d.weighted() ? d.weights() + begin : nullptr,
+                                                        length, dgd->exp_mode);
+        });
+    }
+
+    // Float32 objective for NelderMead<float> over float datasets: model in
+    // float, SSR accumulated in double and rounded once on return
+    static float objective_single(const float* params, size_t n, void* data) {
+        static_assert(std::is_same<S, float>::value, "The single-precision objective needs float samples");
+        DoubleGaussianDataset* dgd = static_cast<DoubleGaussianDataset*>(data);
+        return float(GaussianKernels::double_gaussian_ssr_single(params, dgd->data));
+    }
+
+    // Objective plus analytic gradient (ParameterCount values) in one pass
+    static double objective_gradient(const double* params, size_t n, double* grad, void* data) {
+        DoubleGaussianDataset* dgd = static_cast<DoubleGaussianDataset*>(data);
+        return GaussianKernels::double_gaussian_ssr_grad(params, dgd->data, grad, dgd->exp_mode);
+    }
+
+    // Gauss-Newton normal equations for LevenbergMarquardt<ParameterCount>
+    static double normal_equations(const double* params, double* jtj, double* jtr, void* data) {
+        DoubleGaussianDataset* dgd = static_cast<DoubleGaussianDataset*>(data);
+        return GaussianKernels::double_gaussian_normal_equations(params, dgd->data, jtj, jtr, dgd->exp_mode);
+    }
+};
+
+typedef DoubleGaussianDataset<double> DoubleGaussianData;
+typedef DoubleGaussianDataset<float> DoubleGaussianDataF;
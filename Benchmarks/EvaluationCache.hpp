@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ScratchArena.hpp"
+
+// Fixed-size, direct-mapped memo of recent objective values, keyed on the
+// exact bits of the parameter vector. The solver consults it before every
+// evaluation, so a point it has already evaluated - a shrink or contraction
+// that lands on a vertex it has seen, typically once the simplex has
+// collapsed to rounding level or is pinned against a bound - costs a hash
+// and a compare instead of a pass over the data. A colliding point simply
+// replaces the entry. Keys compare bitwise: -0.0 and 0.0 are different
+// points, and a NaN coordinate matches only the same NaN.
+//
+// Only worth it for expensive objectives: the lookup costs O(n) per
+// evaluation, hit or miss. The entries are blocks of the owning solver's
+// scratch arena, carved afresh for every fit.
+template<typename T>
+class EvaluationCache {
+public:
+    // Bytes reset() takes from the arena
+    static size_t footprint(size_t capacity, size_t n) {
+        size_t slots = slot_count(capacity);
+        return ScratchArena::footprint<T>(slots * n) + ScratchArena::footprint<T>(slots) +
+               ScratchArena::footprint<uint8_t>(slots);
+    }
+
+    // Empties the cache and places it in arena, sized for n-dimensional
+    // points; the capacity is rounded up to a power of two. The arena must
+    // have footprint(capacity, n) bytes free.
+    void reset(size_t capacity, size_t n, ScratchArena& arena) {
+        slots_ = slot_count(capacity);
+        n_ = n;
+        mask_ = slots_ - 1;
+        keys_ = arena.allocate<T>(slots_ * n);
+        values_ = arena.allocate<T>(slots_);
+        used_ = arena.allocate<uint8_t>(slots_);
+        std::memset(used_, 0, slots_);
+    }
+
+    // Slot of x; true, with its value, when the slot holds exactly x
+    bool lookup(const T* x, size_t& slot, T& value) const {
+        slot = hash(x) & mask_;
+        if (!used_[slot] || std::memcmp(keys_ + slot * n_, x, n_ * sizeof(T)) != 0) return false;
+        value = values_[slot];
+        return true;
+    }
+
+    void store(size_t slot, const T* x, T value) {
+        std::memcpy(keys_ + slot * n_, x, n_ * sizeof(T));
+        values_[slot] = value;
+        used_[slot] = 1;
+    }
+
+    size_t capacity() const { return slots_; }
+
+private:
+    T* keys_ = nullptr;
+    T* values_ = nullptr;
+    uint8_t* used_ = nullptr;
+    size_t slots_ = 0;
+    size_t n_ = 0;
+    size_t mask_ = 0;
+
+    static size_t slot_count(size_t capacity) {
+        size_t slots = 1;
+        while (slots < capacity) slots <<= 1;
+        return slots;
+    }
+
+    // Multiply-rotate over the coordinate bits, then the splitmix64 finalizer
+    uint64_t hash(const T* x) const {
+        uint64_t h = 0x9E3779B97F4A7C15ull;
+        for (size_t j = 0; j < n_; j++) {
+            uint64_t bits = 0;
+            std::memcpy(&bits, x + j, sizeof(T) < sizeof(bits) ? sizeof(T) : sizeof(bits));
+            h = (h ^ bits) * 0xBF58476D1CE4E5B9ull;
+            h = (h << 31) | (h >> 33);
+        }
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return h;
+    }
+};
@@ -0,0 +1,792 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Dataset.hpp"
+
+#if defined(BENCHMARK_DISPATCH) && !defined(GAUSSIAN_KERNELS_NAMESPACE)
+#include "KernelDispatch.hpp"
+#define GAUSSIAN_KERNELS_DISPATCH
+#endif
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Vectorized Double Gaussian kernels.
+//
+// Each kernel is written once against a small vector type (SimdScalar,
+// SimdAvx2, SimdAvx512, SimdNeon) and runs 8 (AVX-512), 4 (AVX2+FMA) or
+// 2 (NEON) samples per step, with the scalar type covering the tail and builds
+// without any of those instruction sets.
+//
+// Data may be stored as double or float; the kernels below widen float
+// samples to double on load so the model and the accumulation run in double
+// precision.
+// Optional per-sample weights turn the SSR into sum(w * r^2).
+//
+// ExpMode::Fast uses the polynomial exp below. Range reduction is
+// x = k*ln2 + r with |r| <= ln2/2 (Cody-Waite split of ln2), followed by a
+// degree-13 Taylor polynomial for e^r, whose truncation error is below 4e-18.
+// Measured against std::exp over [-708, 0] in steps of 1e-4 the relative
+// error stays within 1 ulp (2.2e-16). Inputs below -708 return exactly 0, which
+// only differs from libm by subnormals. ExpMode::Accurate calls std::exp per
+// sample and is the reference the fast path is validated against.
+//
+// double_gaussian_ssr_single() is the float32 fast path for float datasets:
+// the model, the exp and the residuals run in float on vectors of twice as
+// many lanes (Simd*F), and only the squared residuals are widened and summed
+// in double, so the SSR of a long dataset does not lose digits to the sum.
+// Its exp reduces the same way with a float split of ln2 and uses the
+// degree-7 Cephes expf polynomial; measured against std::exp over [-87, 0]
+// the relative error stays below 8.3e-8 (1 float ulp is up to 1.2e-7).
+// Inputs below -87 return 0.
+//
+// multi_gaussian_ssr() generalizes the SSR to K components (1..8) plus an
+// optional constant and/or linear baseline, with K fixed at compile time so
+// the component loop unrolls and all K exps of a vector step are independent.
+//
+// The vector type is chosen at compile time from the target's -m flags. The
+// portable builds (-DBENCHMARK_DISPATCH) instead compile this header once more
+// per instruction set, each copy inside its own namespace (KernelTable.hpp),
+// and the global GaussianKernels forwards its Fast kernels to the copy
+// KernelDispatch selected for the running CPU; ExpMode::Accurate stays in the
+// calling translation unit.
+enum class ExpMode { Fast, Accurate };
+
+// Baseline terms of the multi-Gaussian model; combine with |. Their
+// parameters follow the components: the offset first, then the slope.
+enum BaselineTerms : unsigned { NoBaseline = 0, ConstantBaseline = 1, LinearBaseline = 2 };
+
+#if defined(GAUSSIAN_KERNELS_NAMESPACE)
+namespace GAUSSIAN_KERNELS_NAMESPACE {
+#endif
+
+struct SimdScalar {
+    typedef double Reg;
+    static constexpr size_t Lanes = 1;
+
+    static Reg set1(double a) { return a; }
+    static Reg load(const double* p) { return *p; }
+    static Reg load(const float* p) { return *p; }
+    static Reg add(Reg a, Reg b) { return a + b; }
+    static Reg sub(Reg a, Reg b) { return a - b; }
+    static Reg mul(Reg a, Reg b) { return a * b; }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return a * b + c; }
+    static Reg fnmadd(Reg a, Reg b, Reg c) { return c - a * b; }
+    static Reg min(Reg a, Reg b) { return a < b ? a : b; }
+    static Reg max(Reg a, Reg b) { return a > b ? a : b; }
+    // Round to nearest by pushing the fraction out of the mantissa (|a| < 2^51)
+    static Reg round(Reg a) { return (a + 6755399441055744.0) - 6755399441055744.0; }
+    static Reg zero_below(Reg value, Reg x, double threshold) { return x < threshold ? 0.0 : value; }
+    static double reduce(Reg a) { return a; }
+
+    // 2^k for integral k in the double exponent range
+    static Reg pow2(Reg k) {
+        int64_t bits = (static_cast<int64_t>(k) + 1023) << 52;
+        double scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return scale;
+    }
+};
+
+// Float lanes for the single-precision kernel. Wide is the double vector type
+// widen_add() accumulates into: the lower and upper halves of a float vector
+// go to low and high.
+struct SimdScalarF {
+    typedef float Reg;
+    typedef SimdScalar Wide;
+    static constexpr size_t Lanes = 1;
+
+    static Reg set1(float a) { return a; }
+    static Reg load(const float* p) { return *p; }
+    static Reg add(Reg a, Reg b) { return a + b; }
+    static Reg sub(Reg a, Reg b) { return a - b; }
+    static Reg mul(Reg a, Reg b) { return a * b; }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return a * b + c; }
+    static Reg fnmadd(Reg a, Reg b, Reg c) { return c - a * b; }
+    static Reg min(Reg a, Reg b) { return a < b ? a : b; }
+    static Reg max(Reg a, Reg b) { return a > b ? a : b; }
+    // Round to nearest by pushing the fraction out of the mantissa (|a| < 2^22)
+    static Reg round(Reg a) { return (a + 12582912.0f) - 12582912.0f; }
+    static Reg zero_below(Reg value, Reg x, float threshold) { return x < threshold ? 0.0f : value; }
+    static void widen_add(Reg a, Wide::Reg& low, Wide::Reg&) { low += double(a); }
+
+    // 2^k for integral k in the float exponent range
+    static Reg pow2(Reg k) {
+        int32_t bits = (static_cast<int32_t>(k) + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return scale;
+    }
+};
+
+#if defined(__AVX512F__)
+struct SimdAvx512 {
+    typedef __m512d Reg;
+    static constexpr size_t Lanes = 8;
+
+    static Reg set1(double a) { return _mm512_set1_pd(a); }
+    static Reg load(const double* p) { return _mm512_loadu_pd(p); }
+    static Reg load(const float* p) { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+    static Reg add(Reg a, Reg b) { return _mm512_add_pd(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm512_sub_pd(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm512_mul_pd(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_pd(a, b, c); }
+    static Reg fnmadd(Reg a, Reg b, Reg c) { return _mm512_fnmadd_pd(a, b, c); }
+    static Reg min(Reg a, Reg b) { return _mm512_min_pd(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm512_max_pd(a, b); }
+    static Reg round(Reg a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Reg zero_below(Reg value, Reg x, double threshold) {
+        __mmask8 below = _mm512_cmp_pd_mask(x, set1(threshold), _CMP_LT_OQ);
+        return _mm512_mask_blend_pd(below, value, _mm512_setzero_pd());
+    }
+    static double reduce(Reg a) { return _mm512_reduce_add_pd(a); }
+
+    static Reg pow2(Reg k) {
+        // k fits in int32; pd->epi64 would need AVX512DQ
+        __m512i k64 = _mm512_cvtepi32_epi64(_mm512_cvtpd_epi32(k));
+        return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_add_epi64(k64, _mm512_set1_epi64(1023)), 52));
+    }
+};
+
+struct SimdAvx512F {
+    typedef __m512 Reg;
+    typedef SimdAvx512 Wide;
+    static constexpr size_t Lanes = 16;
+
+    static Reg set1(float a) { return _mm512_set1_ps(a); }
+    static Reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+    static Reg fnmadd(Reg a, Reg b, Reg c) { return _mm512_fnmadd_ps(a, b, c); }
+    static Reg min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+    static Reg round(Reg a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Reg zero_below(Reg value, Reg x, float threshold) {
+        __mmask16 below = _mm512_cmp_ps_mask(x, set1(threshold), _CMP_LT_OQ);
+        return _mm512_mask_blend_ps(below, value, _mm512_setzero_ps());
+    }
+    static void widen_add(Reg a, Wide::Reg& low, Wide::Reg& high) {
+        // Upper half through the pd cast; extractf32x8 would need AVX512DQ
+        __m256 upper = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1));
+        low = _mm512_add_pd(low, _mm512_cvtps_pd(_mm512_castps512_ps256(a)));
+        high = _mm512_add_pd(high, _mm512_cvtps_pd(upper));
+    }
+
+    static Reg pow2(Reg k) {
+        return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(k),
+                                                                      _mm512_set1_epi32(127)), 23));
+    }
+};
+typedef SimdAvx512 SimdNative;
+typedef SimdAvx512F SimdNativeF;
+#elif defined(__AVX2__) && defined(__FMA__)
+struct SimdAvx2 {
+    typedef __m256d Reg;
+    static constexpr size_t Lanes = 4;
+
+    static Reg set1(double a) { return _mm256_set1_pd(a); }
+    static Reg load(const double* p) { return _mm256_loadu_pd(p); }
+    static Reg load(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+    static Reg add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_pd(a, b, c); }
+    static Reg fnmadd(Reg a, Reg b, Reg c) { return _mm256_fnmadd_pd(a, b, c); }
+    static Reg min(Reg a, Reg b) { return _mm256_min_pd(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm256_max_pd(a, b); }
+    static Reg round(Reg a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Reg zero_below(Reg value, Reg x, double threshold) {
+        return _mm256_andnot_pd(_mm256_cmp_pd(x, set1(threshold), _CMP_LT_OQ), value);
+    }
+    static double reduce(Reg a) {
+        __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+    }
+
+    static Reg pow2(Reg k) {
+        // k fits in int32, so convert through epi32 (AVX2 has no pd->epi64)
+        __m256i k64 = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(k64, _mm256_set1_epi64x(1023)), 52));
+    }
+};
+
+struct SimdAvx2F {
+    typedef __m256 Reg;
+    typedef SimdAvx2 Wide;
+    static constexpr size_t Lanes = 8;
+
+    static Reg set1(float a) { return _mm256_set1_ps(a); }
+    static Reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+    static Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+    static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+    static Reg fnmadd(Reg a, Reg b, Reg c) { return _mm256_fnmadd_ps(a, b, c); }
+    static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+    static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+    static Reg round(Reg a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Reg zero_below(Reg value, Reg x, float threshold) {
+        return _mm256_andnot_ps(_mm256_cmp_ps(x, set1(threshold), _CMP_LT_OQ), value);
+    }
+    static void widen_add(Reg a, Wide::Reg& low, Wide::Reg& high) {
+        low = _mm256_add_pd(low, _mm256_cvtps_pd(_mm256_castps256_ps128(a)));
+        high = _mm256_add_pd(high, _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)));
+    }
+
+    static Reg pow2(Reg k) {
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(k),
+                                                                      _mm256_set1_epi32(127)), 23));
+    }
+};
+typedef SimdAvx2 SimdNative;
+typedef SimdAvx2F SimdNativeF;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+struct SimdNeon {
+    typedef float64x2_t Reg;
+    static constexpr size_t Lanes = 2;
+
+    static Reg set1(double a) { return vdupq_n_f64(a); }
+    static Reg load(const double* p) { return vld1q_f64(p); }
+    static Reg load(const float* p) { return vcvt_f64_f32(vld1_f32(p)); }
+    static Reg add(Reg a, Reg b) { return vaddq_f64(a, b); }
+    static Reg sub(Reg a, Reg b) { return vsubq_f64(a, b); }
+    static Reg mul(Reg a, Reg b) { return vmulq_f64(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return vfmaq_f64(c, a, b); }
+    static Reg fnmadd(Reg a, Reg b, Reg c) { return vfmsq_f64(c, a, b); }
+    static Reg min(Reg a, Reg b) { return vminq_f64(a, b); }
+    static Reg max(Reg a, Reg b) { return vmaxq_f64(a, b); }
+    static Reg round(Reg a) { return vrndnq_f64(a); }
+    static Reg zero_below(Reg value, Reg x, double threshold) {
+        uint64x2_t below = vcltq_f64(x, set1(threshold));
+        return vreinterpretq_f64_u64(vbicq_u64(vreinterpretq_u64_f64(value), below));
+    }
+    static double reduce(Reg a) { return vaddvq_f64(a); }
+
+    static Reg pow2(Reg k) {
+        return vreinterpretq_f64_s64(vshlq_n_s64(vaddq_s64(vcvtq_s64_f64(k), vdupq_n_s64(1023)), 52));
+    }
+};
+
+struct SimdNeonF {
+    typedef float32x4_t Reg;
+    typedef SimdNeon Wide;
+    static constexpr size_t Lanes = 4;
+
+    static Reg set1(float a) { return vdupq_n_f32(a); }
+    static Reg load(const float* p) { return vld1q_f32(p); }
+    static Reg add(Reg a, Reg b) { return vaddq_f32(a, b); }
+    static Reg sub(Reg a, Reg b) { return vsubq_f32(a, b); }
+    static Reg mul(Reg a, Reg b) { return vmulq_f32(a, b); }
+    static Reg fmadd(Reg a, Reg b, Reg c) { return vfmaq_f32(c, a, b); }
+    static Reg fnmadd(Reg a, Reg b, Reg c) { return vfmsq_f32(c, a, b); }
+    static Reg min(Reg a, Reg b) { return vminq_f32(a, b); }
+    static Reg max(Reg a, Reg b) { return vmaxq_f32(a, b); }
+    static Reg round(Reg a) { return vrndnq_f32(a); }
+    static Reg zero_below(Reg value, Reg x, float threshold) {
+        uint32x4_t below = vcltq_f32(x, set1(threshold));
+        return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(value), below));
+    }
+    static void widen_add(Reg a, Wide::Reg& low, Wide::Reg& high) {
+        low = vaddq_f64(low, vcvt_f64_f32(vget_low_f32(a)));
+        high = vaddq_f64(high, vcvt_high_f64_f32(a));
+    }
+
+    static Reg pow2(Reg k) {
+        return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(k), vdupq_n_s32(127)), 23));
+    }
+};
+typedef SimdNeon SimdNative;
+typedef SimdNeonF SimdNativeF;
+#else
+typedef SimdScalar SimdNative;
+typedef SimdScalarF SimdNativeF;
+#endif
+
+class GaussianKernels {
+public:
+    static constexpr size_t Lanes = SimdNative::Lanes;
+    static constexpr size_t SingleLanes = SimdNativeF::Lanes;
+#if defined(__AVX512F__)
+    static constexpr const char* Path = "avx512";
+#elif defined(__AVX2__) && defined(__FMA__)
+    static constexpr const char* Path = "avx2";
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static constexpr const char* Path = "neon";
+#else
+    static constexpr const char* Path = "scalar";
+#endif
+
+#if defined(GAUSSIAN_KERNELS_DISPATCH)
+    static constexpr bool Dispatched = true;
+#else
+    static constexpr bool Dispatched = false;
+#endif
+
+    // Path the Fast kernels run: Path, or in a dispatch build the one
+    // KernelDispatch selected
+    static const char* path() {
+#if defined(GAUSSIAN_KERNELS_DISPATCH)
+        return KernelDispatch::kernels().path;
+#else
+        return Path;
+#endif
+    }
+
+    // Polynomial exp on any vector type; see the accuracy notes above
+    template<typename V>
+    static typename V::Reg exp(typename V::Reg x) {
+        typename V::Reg input = x;
+        x = V::min(V::max(x, V::set1(ExpMin)), V::set1(ExpMax));
+        typename V::Reg k = V::round(V::mul(x, V::set1(Log2e)));
+        typename V::Reg r = V::fnmadd(k, V::set1(Ln2Hi), x);
+        r = V::fnmadd(k, V::set1(Ln2Lo), r);
+        typename V::Reg p = V::set1(C13);
+        p = V::fmadd(p, r, V::set1(C12));
+        p = V::fmadd(p, r, V::set1(C11));
+        p = V::fmadd(p, r, V::set1(C10));
+        p = V::fmadd(p, r, V::set1(C9));
+        p = V::fmadd(p, r, V::set1(C8));
+        p = V::fmadd(p, r, V::set1(C7));
+        p = V::fmadd(p, r, V::set1(C6));
+        p = V::fmadd(p, r, V::set1(C5));
+        p = V::fmadd(p, r, V::set1(C4));
+        p = V::fmadd(p, r, V::set1(C3));
+        p = V::fmadd(p, r, V::set1(C2));
+        p = V::fmadd(p, r, V::set1(1.0));
+        p = V::fmadd(p, r, V::set1(1.0));
+        return V::zero_below(V::mul(p, V::pow2(k)), input, ExpMin);
+    }
+
+    static double fast_exp(double x) { return exp<SimdScalar>(x); }
+
+    // Float polynomial exp for the single-precision kernel
+    template<typename V>
+    static typename V::Reg exp_single(typename V::Reg x) {
+        typename V::Reg input = x;
+        x = V::min(V::max(x, V::set1(ExpMinF)), V::set1(ExpMaxF));
+        typename V::Reg k = V::round(V::mul(x, V::set1(Log2eF)));
+        typename V::Reg r = V::fnmadd(k, V::set1(Ln2HiF), x);
+        r = V::fnmadd(k, V::set1(Ln2LoF), r);
+        typename V::Reg p = V::set1(F7);
+        p = V::fmadd(p, r, V::set1(F6));
+        p = V::fmadd(p, r, V::set1(F5));
+        p = V::fmadd(p, r, V::set1(F4));
+        p = V::fmadd(p, r, V::set1(F3));
+        p = V::fmadd(p, r, V::set1(F2));
+        p = V::fmadd(p, V::mul(r, r), r);
+        p = V::add(p, V::set1(1.0f));
+        return V::zero_below(V::mul(p, V::pow2(k)), input, ExpMinF);
+    }
+
+    static float fast_exp_single(float x) { return exp_single<SimdScalarF>(x); }
+
+    // Sum of squared residuals of the Double Gaussian
+    // [A1, mu1, sigma1, A2, mu2, sigma2] against (x[i], y[i]), i < count,
+    // weighted by w[i] when w is not null.
+    template<typename S>
+    static double double_gaussian_ssr(const double* params, const S* x, const S* y, const S* w,
+                                      size_t count, ExpMode mode = ExpMode::Fast) {
+#if defined(GAUSSIAN_KERNELS_DISPATCH)
+        if (mode == ExpMode::Fast) return KernelDispatch::kernels().samples<S>().ssr(params, x, y, w, count);
+#endif
+        double acc[7] = {0, 0, 0, 0, 0, 0, 0};
+        if (mode == ExpMode::Accurate)
+            run<SimdScalar, true, false>(params, x, y, w, 0, count, acc);
+        else
+            run<SimdNative, false, false>(params, x, y, w, 0, count, acc);
+        return acc[0];
+    }
+
+    template<typename S>
+    static double double_gaussian_ssr(const double* params, const S* x, const S* y,
+                                      size_t count, ExpMode mode = ExpMode::Fast) {
+        return double_gaussian_ssr(params, x, y, static_cast<const S*>(nullptr), count, mode);
+    }
+
+    // Padded datasets run entirely in the vector loop
+    template<typename S>
+    static double double_gaussian_ssr(const double* params, const Dataset<S>& data,
+                                      ExpMode mode = ExpMode::Fast) {
+        return double_gaussian_ssr(params, data.x(), data.y(), data.weights(), data.padded_size(), mode);
+    }
+
+    // Single-precision SSR over float samples: model and residuals in float,
+    // squared residuals summed in double (see the notes above). params are
+    // the float32 parameters; w may be null.
+    static double double_gaussian_ssr_single(const float* params, const float* x, const float* y, const float* w,
+                                             size_t count) {
+#if defined(GAUSSIAN_KERNELS_DISPATCH)
+        return KernelDispatch::kernels().ssr_single(params, x, y, w, count);
+#else
+        SimdNativeF::Wide::Reg low = SimdNativeF::Wide::set1(0.0), high = low;
+        size_t i = w ? single_loop<SimdNativeF, true>(params, x, y, w, 0, count, low, high)
+                     : single_loop<SimdNativeF, false>(params, x, y, w, 0, count, low, high);
+        double ssr = SimdNativeF::Wide::reduce(SimdNativeF::Wide::add(low, high));
+        if constexpr (SimdNativeF::Lanes > 1) {
+            if (i < count) {
+                double tail = 0.0, unused = 0.0;
+                w ? single_loop<SimdScalarF, true>(params, x, y, w, i, count, tail, unused)
+                  : single_loop<SimdScalarF, false>(params, x, y, w, i, count, tail, unused);
+                ssr += tail;
+            }
+        }
+        return ssr;
+#endif
+    }
+
+    static double double_gaussian_ssr_single(const float* params, const Dataset<float>& data) {
+        return double_gaussian_ssr_single(params, data.x(), data.y(), data.weights(), data.padded_size());
+    }
+
+    // Sum of squared residuals of sum_k A_k exp(-((x - mu_k) / sigma_k)^2 / 2)
+    // plus the baseline selected by Terms, for params
+    // [A1, mu1, sigma1, ..., AK, muK, sigmaK, offset?, slope?]. w may be null.
+    template<size_t K, unsigned Terms, typename S>
+    static double multi_gaussian_ssr(const double* params, const S* x, const S* y, const S* w,
+                                     size_t count, ExpMode mode = ExpMode::Fast) {
+        static_assert(K >= 1 && K <= MaxComponents, "The multi-Gaussian kernel takes 1 to 8 components");
+#if defined(GAUSSIAN_KERNELS_DISPATCH)
+        if (mode == ExpMode::Fast)
+            return KernelDispatch::kernels().samples<S>().multi[K - 1][Terms](params, x, y, w, count);
+#endif
+        double ssr = 0.0;
+        if (mode == ExpMode::Accurate)
+            run_multi<SimdScalar, true, K, Terms>(params, x, y, w, 0, count, ssr);
+        else
+            run_multi<SimdNative, false, K, Terms>(params, x, y, w, 0, count, ssr);
+        return ssr;
+    }
+
+    // Without a baseline, padded datasets run entirely in the vector loop; a
+    // baseline is not zero at the padding (x = +inf), so those stop at size()
+    template<size_t K, unsigned Terms, typename S>
+    static double multi_gaussian_ssr(const double* params, const Dataset<S>& data,
+                                     ExpMode mode = ExpMode::Fast) {
+        size_t count = Terms == NoBaseline ? data.padded_size() : data.size();
+        return multi_gaussian_ssr<K, Terms>(params, data.x(), data.y(), data.weights(), count, mode);
+    }
+
+    // Fused SSR and gradient. All six partials reuse the two exp terms of the
+    // value: with z = (x - mu) / sigma and e = exp(-z^2 / 2),
+    //   dg/dA = e,  dg/dmu = A e z / sigma,  dg/dsigma = A e z^2 / sigma,
+    // and dSSR/dtheta = -2 sum(w r dg/dtheta). grad receives six values.
+    template<typename S>
+    static double double_gaussian_ssr_grad(const double* params, const S* x, const S* y, const S* w,
+                                           size_t count, double* grad, ExpMode mode = ExpMode::Fast) {
+#if defined(GAUSSIAN_KERNELS_DISPATCH)
+        if (mode == ExpMode::Fast)
+            return KernelDispatch::kernels().samples<S>().ssr_grad(params, x, y, w, count, grad);
+#endif
+        double acc[7] = {0, 0, 0, 0, 0, 0, 0};
+        if (mode == ExpMode::Accurate)
+            run<SimdScalar, true, true>(params, x, y, w, 0, count, acc);
+        else
+            run<SimdNative, false, true>(params, x, y, w, 0, count, acc);
+        for (int k = 0; k < 6; k++) grad[k] = -2.0 * acc[k + 1];
+        return acc[0];
+    }
+
+    template<typename S>
+    static double double_gaussian_ssr_grad(const double* params, const Dataset<S>& data, double* grad,
+                                           ExpMode mode = ExpMode::Fast) {
+        return double_gaussian_ssr_grad(params, data.x(), data.y(), data.weights(), data.padded_size(),
+                                        grad, mode);
+    }
+
+    // Gauss-Newton normal equations for the weighted least-squares fit,
+    // accumulated in one pass. With J[i][k] = dg(x[i])/dtheta_k (the same
+    // partials as above) and r = y - g, writes the 6x6 matrix J^T W J
+    // row-major to jtj and J^T W r to jtr, and returns the SSR.
+    template<typename S>
+    static double double_gaussian_normal_equations(const double* params, const S* x, const S* y, const S* w,
+                                                   size_t count, double* jtj, double* jtr,
+                                                   ExpMode mode = ExpMode::Fast) {
+#if defined(GAUSSIAN_KERNELS_DISPATCH)
+        if (mode == ExpMode::Fast)
+            return KernelDispatch::kernels().samples<S>().normal_equations(params, x, y, w, count, jtj, jtr);
+#endif
+        double acc[NormalAccumulators] = {};
+        if (mode == ExpMode::Accurate)
+            run_normal<SimdScalar, true>(params, x, y, w, 0, count, acc);
+        else
+            run_normal<SimdNative, false>(params, x, y, w, 0, count, acc);
+        for (int k = 0; k < 6; k++) jtr[k] = acc[1 + k];
+        const double* upper = acc + 7;
+        for (int k = 0; k < 6; k++) {
+            for (int l = k; l < 6; l++) {
+                jtj[k * 6 + l] = jtj[l * 6 + k] = *upper++;
+            }
+        }
+        return acc[0];
+    }
+
+    template<typename S>
+    static double double_gaussian_normal_equations(const double* params, const Dataset<S>& data,
+                                                   double* jtj, double* jtr, ExpMode mode = ExpMode::Fast) {
+        return double_gaussian_normal_equations(params, data.x(), data.y(), data.weights(), data.padded_size(),
+                                                jtj, jtr, mode);
+    }
+
+    static constexpr size_t MaxComponents = 8;
+
+private:
+    // SSR, J^T W r (6) and the upper triangle of J^T W J (21)
+    static constexpr size_t NormalAccumulators = 28;
+
+    static constexpr double Log2e = 1.4426950408889634;
+    static constexpr double Ln2Hi = 6.93147180369123816490e-01;
+    static constexpr double Ln2Lo = 1.90821492927058770002e-10;
+    static constexpr double ExpMin = -708.0;
+    static constexpr double ExpMax = 709.0;
+    static constexpr double MinNormal = 2.2250738585072014e-308;
+
+    // Single-precision exp: float Cody-Waite split of ln2 and the Cephes
+    // expf coefficients, e^r = 1 + r + r^2 (F2 + F3 r + ... + F7 r^5)
+    static constexpr float Log2eF = 1.44269504088896341f;
+    static constexpr float Ln2HiF = 0.693359375f;
+    static constexpr float Ln2LoF = -2.12194440e-4f;
+    static constexpr float ExpMinF = -87.0f;
+    static constexpr float ExpMaxF = 88.0f;
+    static constexpr float F7 = 1.9875691500e-4f;
+    static constexpr float F6 = 1.3981999507e-3f;
+    static constexpr float F5 = 8.3334519073e-3f;
+    static constexpr float F4 = 4.1665795894e-2f;
+    static constexpr float F3 = 1.6666665459e-1f;
+    static constexpr float F2 = 5.0000001201e-1f;
+
+    // 1/k! for k = 2..13, highest order first for Horner evaluation
+    static constexpr double C13 = 1.0 / 6227020800.0;
+    static constexpr double C12 = 1.0 / 479001600.0;
+    static constexpr double C11 = 1.0 / 39916800.0;
+    static constexpr double C10 = 1.0 / 3628800.0;
+    static constexpr double C9 = 1.0 / 362880.0;
+    static constexpr double C8 = 1.0 / 40320.0;
+    static constexpr double C7 = 1.0 / 5040.0;
+    static constexpr double C6 = 1.0 / 720.0;
+    static constexpr double C5 = 1.0 / 120.0;
+    static constexpr double C4 = 1.0 / 24.0;
+    static constexpr double C3 = 1.0 / 6.0;
+    static constexpr double C2 = 0.5;
+
+    template<typename V, bool UseStdExp>
+    static typename V::Reg model_exp(typename V::Reg x) {
+        if constexpr (UseStdExp) return std::exp(x);
+        else return exp<V>(x);
+    }
+
+    // Runs the vector loop and then the scalar tail over [begin, end)
+    template<typename V, bool UseStdExp, bool Gradient, typename S>
+    static void run(const double* params, const S* x, const S* y, const S* w,
+                    size_t begin, size_t end, double* acc) {
+        size_t i = w ? loop<V, UseStdExp, Gradient, true>(params, x, y, w, begin, end, acc)
+                     : loop<V, UseStdExp, Gradient, false>(params, x, y, w, begin, end, acc);
+        if constexpr (V::Lanes > 1) {
+            if (i < end) {
+                w ? loop<SimdScalar, UseStdExp, Gradient, true>(params, x, y, w, i, end, acc)
+                  : loop<SimdScalar, UseStdExp, Gradient, false>(params, x, y, w, i, end, acc);
+            }
+        }
+    }
+
+    // Accumulates the SSR into acc[0] and, for Gradient, sum(w r dg/dtheta_k)
+    // into acc[1..6]. Returns the first index it did not process.
+    template<typename V, bool UseStdExp, bool Gradient, bool Weighted, typename S>
+    static size_t loop(const double* params, const S* x, const S* y, const S* w,
+                       size_t begin, size_t end, double* acc) {
+        typedef typename V::Reg R;
+        const R a1 = V::set1(params[0]), mu1 = V::set1(params[1]), inv1 = V::set1(1.0 / params[2]);
+        const R a2 = V::set1(params[3]), mu2 = V::set1(params[4]), inv2 = V::set1(1.0 / params[5]);
+        const R neg_half = V::set1(-0.5);
+        R ssr = V::set1(0.0);
+        R ga1 = ssr, gmu1 = ssr, gs1 = ssr, ga2 = ssr, gmu2 = ssr, gs2 = ssr;
+        size_t i = begin;
+        for (; i + V::Lanes <= end; i += V::Lanes) {
+            R xv = V::load(x + i);
+            R z1 = V::mul(V::sub(xv, mu1), inv1);
+            R z2 = V::mul(V::sub(xv, mu2), inv2);
+            R e1 = model_exp<V, UseStdExp>(V::mul(V::mul(neg_half, z1), z1));
+            R e2 = model_exp<V, UseStdExp>(V::mul(V::mul(neg_half, z2), z2));
+            R g = V::fmadd(a1, e1, V::mul(a2, e2));
+            R residual = V::sub(V::load(y + i), g);
+            R wr = Weighted ? V::mul(V::load(w + i), residual) : residual;
+            ssr = V::fmadd(wr, residual, ssr);
+
+            if constexpr (Gradient) {
+                // Where e underflows the true partials are below 1e-300; zero z
+                // there so padding (x = +inf) does not produce 0 * inf.
+                z1 = V::zero_below(z1, e1, MinNormal);
+                z2 = V::zero_below(z2, e2, MinNormal);
+                // w r A e z / sigma, reused for the mu and sigma partials
+                R t1 = V::mul(V::mul(wr, V::mul(a1, e1)), V::mul(z1, inv1));
+                R t2 = V::mul(V::mul(wr, V::mul(a2, e2)), V::mul(z2, inv2));
+                ga1 = V::fmadd(wr, e1, ga1);
+                gmu1 = V::add(gmu1, t1);
+                gs1 = V::fmadd(t1, z1, gs1);
+                ga2 = V::fmadd(wr, e2, ga2);
+                gmu2 = V::add(gmu2, t2);
+                gs2 = V::fmadd(t2, z2, gs2);
+            }
+        }
+        acc[0] += V::reduce(ssr);
+        if constexpr (Gradient) {
+            acc[1] += V::reduce(ga1);
+            acc[2] += V::reduce(gmu1);
+            acc[3] += V::reduce(gs1);
+            acc[4] += V::reduce(ga2);
+            acc[5] += V::reduce(gmu2);
+            acc[6] += V::reduce(gs2);
+        }
+        return i;
+    }
+
+    // Single-precision SSR loop; squared residuals are widened into low and
+    // high. Returns the first index it did not process.
+    template<typename V, bool Weighted>
+    static size_t single_loop(const float* params, const float* x, const float* y, const float* w,
+                              size_t begin, size_t end, typename V::Wide::Reg& low,
+                              typename V::Wide::Reg& high) {
+        typedef typename V::Reg R;
+        const R a1 = V::set1(params[0]), mu1 = V::set1(params[1]), inv1 = V::set1(1.0f / params[2]);
+        const R a2 = V::set1(params[3]), mu2 = V::set1(params[4]), inv2 = V::set1(1.0f / params[5]);
+        const R neg_half = V::set1(-0.5f);
+        size_t i = begin;
+        for (; i + V::Lanes <= end; i += V::Lanes) {
+            R xv = V::load(x + i);
+            R z1 = V::mul(V::sub(xv, mu1), inv1);
+            R z2 = V::mul(V::sub(xv, mu2), inv2);
+            R e1 = exp_single<V>(V::mul(V::mul(neg_half, z1), z1));
+            R e2 = exp_single<V>(V::mul(V::mul(neg_half, z2), z2));
+            R residual = V::sub(V::load(y + i), V::fmadd(a1, e1, V::mul(a2, e2)));
+            R wr = Weighted ? V::mul(V::load(w + i), residual) : residual;
+            V::widen_add(V::mul(wr, residual), low, high);
+        }
+        return i;
+    }
+
+    template<typename V, bool UseStdExp, size_t K, unsigned Terms, typename S>
+    static void run_multi(const double* params, const S* x, const S* y, const S* w,
+                          size_t begin, size_t end, double& ssr) {
+        size_t i = w ? multi_loop<V, UseStdExp, K, Terms, true>(params, x, y, w, begin, end, ssr)
+                     : multi_loop<V, UseStdExp, K, Terms, false>(params, x, y, w, begin, end, ssr);
+        if constexpr (V::Lanes > 1) {
+            if (i < end) {
+                w ? multi_loop<SimdScalar, UseStdExp, K, Terms, true>(params, x, y, w, i, end, ssr)
+                  : multi_loop<SimdScalar, UseStdExp, K, Terms, false>(params, x, y, w, i, end, ssr);
+            }
+        }
+    }
+
+    // Adds the multi-Gaussian SSR over [begin, end) to ssr. Returns the first
+    // index it did not process.
+    template<typename V, bool UseStdExp, size_t K, unsigned Terms, bool Weighted, typename S>
+    static size_t multi_loop(const double* params, const S* x, const S* y, const S* w,
+                             size_t begin, size_t end, double& ssr) {
+        typedef typename V::Reg R;
+        R a[K], mu[K], inv[K];
+        for (size_t k = 0; k < K; k++) {
+            a[k] = V::set1(params[3 * k]);
+            mu[k] = V::set1(params[3 * k + 1]);
+            inv[k] = V::set1(1.0 / params[3 * k + 2]);
+        }
+        const double* baseline = params + 3 * K;
+        const R offset = V::set1((Terms & ConstantBaseline) ? baseline[0] : 0.0);
+        const R slope = V::set1((Terms & LinearBaseline) ? baseline[(Terms & ConstantBaseline) ? 1 : 0] : 0.0);
+        const R neg_half = V::set1(-0.5);
+        R sum = V::set1(0.0);
+        size_t i = begin;
+        for (; i + V::Lanes <= end; i += V::Lanes) {
+            R xv = V::load(x + i);
+            R e[K];
+            for (size_t k = 0; k < K; k++) {
+                R z = V::mul(V::sub(xv, mu[k]), inv[k]);
+                e[k] = model_exp<V, UseStdExp>(V::mul(V::mul(neg_half, z), z));
+            }
+            R g = (Terms & LinearBaseline) ? V::fmadd(slope, xv, offset) : offset;
+            for (size_t k = 0; k < K; k++) g = V::fmadd(a[k], e[k], g);
+            R residual = V::sub(V::load(y + i), g);
+            R wr = Weighted ? V::mul(V::load(w + i), residual) : residual;
+            sum = V::fmadd(wr, residual, sum);
+        }
+        ssr += V::reduce(sum);
+        return i;
+    }
+
+    template<typename V, bool UseStdExp, typename S>
+    static void run_normal(const double* params, const S* x, const S* y, const S* w,
+                           size_t begin, size_t end, double* acc) {
+        size_t i = w ? normal_loop<V, UseStdExp, true>(params, x, y, w, begin, end, acc)
+                     : normal_loop<V, UseStdExp, false>(params, x, y, w, begin, end, acc);
+        if constexpr (V::Lanes > 1) {
+            if (i < end) {
+                w ? normal_loop<SimdScalar, UseStdExp, true>(params, x, y, w, i, end, acc)
+                  : normal_loop<SimdScalar, UseStdExp, false>(params, x, y, w, i, end, acc);
+            }
+        }
+    }
+
+    // Accumulates the SSR, J^T W r and the packed upper triangle of J^T W J
+    // into acc (see NormalAccumulators). Returns the first index it did not
+    // process.
+    template<typename V, bool UseStdExp, bool Weighted, typename S>
+    static size_t normal_loop(const double* params, const S* x, const S* y, const S* w,
+                              size_t begin, size_t end, double* acc) {
+        typedef typename V::Reg R;
+        const R a1 = V::set1(params[0]), mu1 = V::set1(params[1]), inv1 = V::set1(1.0 / params[2]);
+        const R a2 = V::set1(params[3]), mu2 = V::set1(params[4]), inv2 = V::set1(1.0 / params[5]);
+        const R neg_half = V::set1(-0.5);
+        R sums[NormalAccumulators];
+        for (size_t k = 0; k < NormalAccumulators; k++) sums[k] = V::set1(0.0);
+        size_t i = begin;
+        for (; i + V::Lanes <= end; i += V::Lanes) {
+            R xv = V::load(x + i);
+            R z1 = V::mul(V::sub(xv, mu1), inv1);
+            R z2 = V::mul(V::sub(xv, mu2), inv2);
+            R e1 = model_exp<V, UseStdExp>(V::mul(V::mul(neg_half, z1), z1));
+            R e2 = model_exp<V, UseStdExp>(V::mul(V::mul(neg_half, z2), z2));
+            R residual = V::sub(V::load(y + i), V::fmadd(a1, e1, V::mul(a2, e2)));
+            z1 = V::zero_below(z1, e1, MinNormal);
+            z2 = V::zero_below(z2, e2, MinNormal);
+
+            // Jacobian row: dg/dA = e, dg/dmu = A e z / sigma, dg/dsigma = z dg/dmu
+            R j[6];
+            j[0] = e1;
+            j[1] = V::mul(V::mul(a1, e1), V::mul(z1, inv1));
+            j[2] = V::mul(j[1], z1);
+            j[3] = e2;
+            j[4] = V::mul(V::mul(a2, e2), V::mul(z2, inv2));
+            j[5] = V::mul(j[4], z2);
+
+            R wr = residual;
+            R wj[6];
+            if constexpr (Weighted) {
+                R wv = V::load(w + i);
+                wr = V::mul(wv, residual);
+                for (int k = 0; k < 6; k++) wj[k] = V::mul(wv, j[k]);
+            } else {
+                for (int k = 0; k < 6; k++) wj[k] = j[k];
+            }
+
+            sums[0] = V::fmadd(wr, residual, sums[0]);
+            size_t slot = 7;
+            for (int k = 0; k < 6; k++) {
+                sums[1 + k] = V::fmadd(wj[k], residual, sums[1 + k]);
+                for (int l = k; l < 6; l++, slot++) sums[slot] = V::fmadd(wj[k], j[l], sums[slot]);
+            }
+        }
+        for (size_t k = 0; k < NormalAccumulators; k++) acc[k] += V::reduce(sums[k]);
+        return i;
+    }
+};
+
+#if defined(GAUSSIAN_KERNELS_NAMESPACE)
+}
+#endif
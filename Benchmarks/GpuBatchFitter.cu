@@ -0,0 +1,400 @@
+// CUDA/HIP implementation of GpuBatchFitter (see GpuBatchFitter.hpp).
+// Build with nvcc, or with hipcc -x hip, through `make gpu`.
+
+#include "GpuBatchFitter.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#if defined(__HIPCC__)
+#include <hip/hip_runtime.h>
+
+typedef hipError_t GpuError;
+typedef hipDeviceProp_t GpuDeviceProperties;
+#define gpuSuccess hipSuccess
+#define gpuGetErrorString hipGetErrorString
+#define gpuGetLastError hipGetLastError
+#define gpuSetDevice hipSetDevice
+#define gpuGetDeviceProperties hipGetDeviceProperties
+#define gpuMalloc hipMalloc
+#define gpuFree hipFree
+#define gpuMemcpy hipMemcpy
+#define gpuMemcpyHostToDevice hipMemcpyHostToDevice
+#define gpuMemcpyDeviceToHost hipMemcpyDeviceToHost
+
+// Wave64 on GCN/CDNA; RDNA builds need -mwavefrontsize64 or GPU_WARP_SIZE=32
+#ifndef GPU_WARP_SIZE
+#define GPU_WARP_SIZE 64
+#endif
+
+__device__ inline double shuffle_xor(double value, int mask) { return __shfl_xor(value, mask); }
+__device__ inline double broadcast(double value, int lane) { return __shfl(value, lane); }
+__device__ inline bool warp_all(bool predicate) { return __all(predicate); }
+
+// Orders the wave's shared-memory writes before its following reads
+__device__ inline void sync_warp() {
+    __builtin_amdgcn_fence(__ATOMIC_RELEASE, "wavefront");
+    __builtin_amdgcn_wave_barrier();
+    __builtin_amdgcn_fence(__ATOMIC_ACQUIRE, "wavefront");
+}
+#else
+#include <cuda_runtime.h>
+
+typedef cudaError_t GpuError;
+typedef cudaDeviceProp GpuDeviceProperties;
+#define gpuSuccess cudaSuccess
+#define gpuGetErrorString cudaGetErrorString
+#define gpuGetLastError cudaGetLastError
+#define gpuSetDevice cudaSetDevice
+#define gpuGetDeviceProperties cudaGetDeviceProperties
+#define gpuMalloc cudaMalloc
+#define gpuFree cudaFree
+#define gpuMemcpy cudaMemcpy
+#define gpuMemcpyHostToDevice cudaMemcpyHostToDevice
+#define gpuMemcpyDeviceToHost cudaMemcpyDeviceToHost
+
+#define GPU_WARP_SIZE 32
+
+__device__ inline double shuffle_xor(double value, int mask) { return __shfl_xor_sync(0xFFFFFFFFu, value, mask); }
+__device__ inline double broadcast(double value, int lane) { return __shfl_sync(0xFFFFFFFFu, value, lane); }
+__device__ inline bool warp_all(bool predicate) { return __all_sync(0xFFFFFFFFu, predicate); }
+__device__ inline void sync_warp() { __syncwarp(); }
+#endif
+
+namespace {
+
+constexpr int WarpSize = GPU_WARP_SIZE;
+constexpr int N = static_cast<int>(BatchFitResult::ParameterCount);
+constexpr int CentroidRefreshInterval = 100;   // as NelderMead
+
+void check(GpuError error, const char* what) {
+    if (error != gpuSuccess) throw std::runtime_error(std::string(what) + ": " + gpuGetErrorString(error));
+}
+
+// One warp's solver state; lives in shared memory
+struct WarpWorkspace {
+    double simplex[(N + 1) * N];
+    double values[N + 1];
+    int indices[N + 1];
+    double vertex_sum[N];
+    double centroid[N];
+    double reflected[N];
+    double expanded[N];
+    double contracted[N];
+};
+
+struct DeviceBatch {
+    const double* x;
+    const double* y;
+    const double* weights;
+    const size_t* offsets;
+    const double* initial_guesses;
+    size_t count;
+};
+
+// Every lane gets lane 0's total. The butterfly sums in a different order in
+// each lane, so without the broadcast lanes could disagree in the last bit
+// and take different branches.
+__device__ double warp_sum(double value) {
+    for (int mask = WarpSize / 2; mask > 0; mask /= 2) value += shuffle_xor(value, mask);
+    return broadcast(value, 0);
+}
+
+// SSR of params over samples [begin, end); lane l takes samples l, l + WarpSize, ...
+__device__ double warp_ssr(const double* params, const DeviceBatch& batch, size_t begin, size_t end, int lane) {
+    const double a1 = params[0], mu1 = params[1], inv_sigma1 = 1.0 / params[2];
+    const double a2 = params[3], mu2 = params[4], inv_sigma2 = 1.0 / params[5];
+    double sum = 0.0;
+    for (size_t i = begin + lane; i < end; i += WarpSize) {
+        double d1 = (batch.x[i] - mu1) * inv_sigma1;
+        double d2 = (batch.x[i] - mu2) * inv_sigma2;
+        double residual = batch.y[i] - (a1 * exp(-0.5 * d1 * d1) + a2 * exp(-0.5 * d2 * d2));
+        double weight = batch.weights ? batch.weights[i] : 1.0;
+        sum += weight * residual * residual;
+    }
+    return warp_sum(sum);
+}
+
+// NelderMead::within()
+__device__ bool within(double old_value, double new_value, double absolute, double relative) {
+    if (isinf(old_value)) return false;
+    double change = old_value - new_value;
+    return change <= absolute || change <= relative * (fabs(old_value) + fabs(new_value)) * 0.5;
+}
+
+// Lane j < N re-sums coordinate j of the vertex sum
+__device__ void sum_vertices(WarpWorkspace& w, int lane) {
+    if (lane < N) {
+        double sum = 0.0;
+        for (int i = 0; i <= N; i++) sum += w.simplex[i * N + lane];
+        w.vertex_sum[lane] = sum;
+    }
+    sync_warp();
+}
+
+// NelderMead::extent_within(), one coordinate per lane
+__device__ bool extent_within(const WarpWorkspace& w, double absolute, double relative, int lane) {
+    bool inside = true;
+    if (lane < N) {
+        double lower = w.simplex[lane];
+        double upper = lower;
+        for (int i = 1; i <= N; i++) {
+            lower = fmin(lower, w.simplex[i * N + lane]);
+            upper = fmax(upper, w.simplex[i * N + lane]);
+        }
+        inside = within(upper, lower, absolute, relative);
+    }
+    return warp_all(inside);
+}
+
+// One Nelder-Mead fit per warp. Control state is held in registers by every
+// lane; it only ever changes based on warp-uniform values, so the warp never
+// diverges outside the per-coordinate and per-sample loops.
+__global__ void fit_kernel(DeviceBatch batch, GpuFitOptions options, BatchFitResult* results) {
+    __shared__ WarpWorkspace workspaces[GpuBatchFitter::WarpsPerBlock];
+
+    const int warp = threadIdx.x / WarpSize;
+    const int lane = threadIdx.x % WarpSize;
+    const size_t fit = size_t(blockIdx.x) * GpuBatchFitter::WarpsPerBlock + warp;
+    if (fit >= batch.count) return;
+
+    WarpWorkspace& w = workspaces[warp];
+    const size_t begin = batch.offsets[fit];
+    const size_t end = batch.offsets[fit + 1];
+    const double* guess = batch.initial_guesses + fit * N;
+    auto evaluate = [&](const double* x) { return warp_ssr(x, batch, begin, end, lane); };
+
+    // NelderMead::initialize_simplex() without bounds
+    for (int k = lane; k < (N + 1) * N; k += WarpSize) {
+        int i = k / N;
+        int j = k % N;
+        double value = guess[j];
+        if (i > 0 && j == i - 1) {
+            double step = fabs(guess[j]) * options.initial_simplex_size;
+            value += step == 0.0 ? options.initial_simplex_size : step;
+        }
+        w.simplex[k] = value;
+    }
+    sync_warp();
+
+    int function_evaluations = 0;
+    for (int i = 0; i <= N; i++) {
+        double value = evaluate(w.simplex + i * N);
+        if (lane == 0) {
+            w.values[i] = value;
+            w.indices[i] = i;
+        }
+        function_evaluations++;
+    }
+    sum_vertices(w, lane);
+
+    const bool track_extent = options.parameter_tolerance > 0.0 || options.parameter_tolerance_rel > 0.0;
+    bool extent_due = track_extent;
+    int replacements = 0;
+
+    // Copies point over the worst vertex and updates the vertex sum
+    auto replace_worst = [&](int worst, const double* point, double value) {
+        double* worst_vertex = w.simplex + worst * N;
+        if (lane < N) {
+            w.vertex_sum[lane] += point[lane] - worst_vertex[lane];
+            worst_vertex[lane] = point[lane];
+        }
+        if (lane == 0) w.values[worst] = value;
+        sync_warp();
+        if (++replacements == CentroidRefreshInterval) {
+            sum_vertices(w, lane);
+            replacements = 0;
+        }
+        if (replacements % (N + 1) == 0) extent_due = track_extent;
+    };
+
+    bool converged = false;
+    int iteration = 0;
+    for (; iteration < options.max_iterations; iteration++) {
+        // Insertion sort of the vertex indices by value
+        if (lane == 0) {
+            for (int i = 1; i <= N; i++) {
+                int current = w.indices[i];
+                double current_value = w.values[current];
+                int j = i;
+                while (j > 0 && w.values[w.indices[j - 1]] > current_value) {
+                    w.indices[j] = w.indices[j - 1];
+                    j--;
+                }
+                w.indices[j] = current;
+            }
+        }
+        sync_warp();
+
+        const int best = w.indices[0];
+        const int worst = w.indices[N];
+        const int second_worst = w.indices[N - 1];
+        const double best_value = w.values[best];
+        const double worst_value = w.values[worst];
+
+        bool function_converged = within(worst_value, best_value,
+                                         options.function_tolerance, options.function_tolerance_rel);
+        bool parameters_converged = false;
+        if (!function_converged && extent_due) {
+            extent_due = false;
+            parameters_converged = extent_within(w, options.parameter_tolerance, options.parameter_tolerance_rel, lane);
+        }
+        if (function_converged || parameters_converged) {
+            converged = true;
+            break;
+        }
+        if (options.max_evaluations > 0 && function_evaluations >= options.max_evaluations) break;
+
+        const double* worst_vertex = w.simplex + worst * N;
+        if (lane < N) {
+            double centroid = (w.vertex_sum[lane] - worst_vertex[lane]) / N;
+            w.centroid[lane] = centroid;
+            w.reflected[lane] = centroid + (centroid - worst_vertex[lane]);
+        }
+        sync_warp();
+        double reflected_value = evaluate(w.reflected);
+        function_evaluations++;
+
+        if (best_value <= reflected_value && reflected_value < w.values[second_worst]) {
+            replace_worst(worst, w.reflected, reflected_value);
+            continue;
+        }
+
+        if (reflected_value < best_value) {
+            if (lane < N) w.expanded[lane] = w.centroid[lane] + options.gamma * (w.reflected[lane] - w.centroid[lane]);
+            sync_warp();
+            double expanded_value = evaluate(w.expanded);
+            function_evaluations++;
+            if (expanded_value < reflected_value)
+                replace_worst(worst, w.expanded, expanded_value);
+            else
+                replace_worst(worst, w.reflected, reflected_value);
+            continue;
+        }
+
+        // Outside contraction from the reflected point, inside from the worst vertex
+        const bool use_reflected = reflected_value < worst_value;
+        const double* contraction_point = use_reflected ? w.reflected : worst_vertex;
+        if (lane < N) w.contracted[lane] = w.centroid[lane] + options.rho * (contraction_point[lane] - w.centroid[lane]);
+        sync_warp();
+        double contracted_value = evaluate(w.contracted);
+        function_evaluations++;
+        if (contracted_value < (use_reflected ? reflected_value : worst_value)) {
+            replace_worst(worst, w.contracted, contracted_value);
+            continue;
+        }
+
+        // Shrink toward the best vertex
+        const double* best_vertex = w.simplex + best * N;
+        for (int i = 1; i <= N; i++) {
+            int vertex = w.indices[i];
+            if (lane < N)
+                w.simplex[vertex * N + lane] = best_vertex[lane] + options.sigma * (w.simplex[vertex * N + lane] - best_vertex[lane]);
+            sync_warp();
+            double value = evaluate(w.simplex + vertex * N);
+            if (lane == 0) w.values[vertex] = value;
+            function_evaluations++;
+        }
+        sync_warp();
+        sum_vertices(w, lane);
+        replacements = 0;
+        extent_due = track_extent;
+    }
+
+    // The loop leaves indices sorted when it breaks; after max_iterations the
+    // last step may have reordered the values, so look the best up again
+    if (lane == 0) {
+        int best = 0;
+        for (int i = 1; i <= N; i++)
+            if (w.values[i] < w.values[best]) best = i;
+        BatchFitResult out;
+        for (int j = 0; j < N; j++) out.parameters[j] = w.simplex[best * N + j];
+        out.final_value = w.values[best];
+        out.function_evaluations = function_evaluations;
+        out.iterations = iteration;
+        out.converged = converged;
+        out.warm_started = false;
+        results[fit] = out;
+    }
+}
+
+// Grows a device buffer to at least bytes; contents are not preserved
+void reserve(void*& buffer, size_t& capacity, size_t bytes) {
+    if (bytes <= capacity) return;
+    if (buffer) check(gpuFree(buffer), "gpuFree");
+    buffer = nullptr;
+    capacity = 0;
+    check(gpuMalloc(&buffer, bytes), "gpuMalloc");
+    capacity = bytes;
+}
+
+}  // namespace
+
+struct GpuBatchFitter::DeviceBuffers {
+    void* x = nullptr;
+    void* y = nullptr;
+    void* weights = nullptr;
+    void* offsets = nullptr;
+    void* guesses = nullptr;
+    void* results = nullptr;
+    size_t x_capacity = 0;
+    size_t y_capacity = 0;
+    size_t weights_capacity = 0;
+    size_t offsets_capacity = 0;
+    size_t guesses_capacity = 0;
+    size_t results_capacity = 0;
+
+    ~DeviceBuffers() {
+        for (void* buffer : {x, y, weights, offsets, guesses, results})
+            if (buffer) gpuFree(buffer);
+    }
+};
+
+GpuBatchFitter::GpuBatchFitter(int device) : device_(new DeviceBuffers()) {
+    check(gpuSetDevice(device), "gpuSetDevice");
+    GpuDeviceProperties properties;
+    check(gpuGetDeviceProperties(&properties, device), "gpuGetDeviceProperties");
+    device_name_ = properties.name;
+}
+
+GpuBatchFitter::~GpuBatchFitter() = default;
+
+void GpuBatchFitter::fit(const GpuBatch& batch, BatchFitResult* results, const GpuFitOptions& options) {
+    if (batch.count == 0) return;
+    const size_t samples = batch.offsets[batch.count];
+    DeviceBuffers& d = *device_;
+
+    reserve(d.x, d.x_capacity, samples * sizeof(double));
+    reserve(d.y, d.y_capacity, samples * sizeof(double));
+    reserve(d.offsets, d.offsets_capacity, (batch.count + 1) * sizeof(size_t));
+    reserve(d.guesses, d.guesses_capacity, batch.count * N * sizeof(double));
+    reserve(d.results, d.results_capacity, batch.count * sizeof(BatchFitResult));
+    check(gpuMemcpy(d.x, batch.x, samples * sizeof(double), gpuMemcpyHostToDevice), "upload x");
+    check(gpuMemcpy(d.y, batch.y, samples * sizeof(double), gpuMemcpyHostToDevice), "upload y");
+    if (batch.weights) {
+        reserve(d.weights, d.weights_capacity, samples * sizeof(double));
+        check(gpuMemcpy(d.weights, batch.weights, samples * sizeof(double), gpuMemcpyHostToDevice), "upload weights");
+    }
+    check(gpuMemcpy(d.offsets, batch.offsets, (batch.count + 1) * sizeof(size_t), gpuMemcpyHostToDevice),
+          "upload offsets");
+    check(gpuMemcpy(d.guesses, batch.initial_guesses, batch.count * N * sizeof(double), gpuMemcpyHostToDevice),
+          "upload initial guesses");
+
+    DeviceBatch device_batch;
+    device_batch.x = static_cast<const double*>(d.x);
+    device_batch.y = static_cast<const double*>(d.y);
+    device_batch.weights = batch.weights ? static_cast<const double*>(d.weights) : nullptr;
+    device_batch.offsets = static_cast<const size_t*>(d.offsets);
+    device_batch.initial_guesses = static_cast<const double*>(d.guesses);
+    device_batch.count = batch.count;
+
+    const unsigned blocks = static_cast<unsigned>((batch.count + WarpsPerBlock - 1) / WarpsPerBlock);
+    fit_kernel<<<blocks, WarpsPerBlock * WarpSize>>>(device_batch, options, static_cast<BatchFitResult*>(d.results));
+    check(gpuGetLastError(), "fit_kernel launch");
+
+    // Blocking copy; also waits for the kernel and reports its errors
+    check(gpuMemcpy(results, d.results, batch.count * sizeof(BatchFitResult), gpuMemcpyDeviceToHost),
+          "download results");
+}
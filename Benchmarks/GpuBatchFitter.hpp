@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BatchFitResult.hpp"
+
+// GPU batch driver for Double Gaussian fits (CUDA or HIP, GpuBatchFitter.cu).
+//
+// Each fit runs on one warp: the simplex, its values and the trial points
+// live in shared memory, every lane sums the residuals of a strided slice of
+// the samples, and a butterfly shuffle reduces the SSR so all lanes hold the
+// same value and take the same branch. Coordinate updates are spread over the
+// first six lanes. The algorithm is NelderMead's: the same initial simplex,
+// coefficients, running vertex sum and NLopt-style stopping tests, so
+// iteration and evaluation counts are comparable with BatchFitter's; final
+// digits differ where the device exp rounds differently from the host kernels.
+//
+// This header has no CUDA or HIP dependency, so the benchmark harness builds
+// with the host compiler and links GpuBatchFitter.o. fit() takes the same
+// datasets (anything with a Dataset<double> member `data`), options and
+// BatchFitResult array as BatchFitter::fit(); bounds, restarts, the evaluation
+// cache and max_time are not supported on the device and are rejected.
+// Samples are packed into one contiguous SoA upload per call; staging and
+// device buffers only grow, so repeated fits of similar batches do not
+// allocate.
+
+// Solver settings the kernel understands, taken from NelderMeadOptions
+struct GpuFitOptions {
+    double function_tolerance = 1e-8;
+    double parameter_tolerance = 1e-8;
+    double function_tolerance_rel = 0.0;
+    double parameter_tolerance_rel = 0.0;
+    double initial_simplex_size = 0.05;
+    double gamma = 2.0;     // expansion
+    double rho = 0.5;       // contraction
+    double sigma = 0.5;     // shrink
+    int max_iterations = 1000;
+    int max_evaluations = 0;
+};
+
+// Packed host batch: dataset d holds samples offsets[d] .. offsets[d + 1] of
+// x, y and (when not null) weights; its initial guess is
+// initial_guesses[d * 6 .. d * 6 + 6)
+struct GpuBatch {
+    const double* x = nullptr;
+    const double* y = nullptr;
+    const double* weights = nullptr;
+    const size_t* offsets = nullptr;
+    const double* initial_guesses = nullptr;
+    size_t count = 0;
+};
+
+class GpuBatchFitter {
+public:
+    // Fits handled per thread block, one warp each
+    static constexpr int WarpsPerBlock = 4;
+
+    explicit GpuBatchFitter(int device = 0);
+    ~GpuBatchFitter();
+
+    GpuBatchFitter(const GpuBatchFitter&) = delete;
+    GpuBatchFitter& operator=(const GpuBatchFitter&) = delete;
+
+    const std::string& device_name() const { return device_name_; }
+
+    // Uploads the packed batch, fits it and downloads count results
+    void fit(const GpuBatch& batch, BatchFitResult* results, const GpuFitOptions& options);
+
+    // Same interface as BatchFitter::fit(); packs the datasets first
+    template<typename Spectrum, typename Options>
+    void fit(const Spectrum* datasets, const double* initial_guesses, size_t count,
+             BatchFitResult* results, const Options& options) {
+        if (!options.lower_bounds.empty() || !options.upper_bounds.empty() || options.max_restarts > 0 ||
+            options.cache_size > 0 || options.max_time > 0.0)
+            throw std::invalid_argument("Bounds, restarts, caching and max_time are not supported on the GPU");
+
+        bool weighted = false;
+        offsets_.assign(1, 0);
+        for (size_t d = 0; d < count; d++) {
+            offsets_.push_back(offsets_.back() + datasets[d].data.size());
+            weighted = weighted || datasets[d].data.weighted();
+        }
+        x_.resize(offsets_.back());
+        y_.resize(offsets_.back());
+        weights_.resize(weighted ? offsets_.back() : 0);
+        for (size_t d = 0; d < count; d++) {
+            const auto& data = datasets[d].data;
+            for (size_t i = 0; i < data.size(); i++) {
+                x_[offsets_[d] + i] = data.x()[i];
+                y_[offsets_[d] + i] = data.y()[i];
+                if (weighted) weights_[offsets_[d] + i] = data.weighted() ? data.weights()[i] : 1.0;
+            }
+        }
+
+        GpuBatch batch;
+        batch.x = x_.data();
+        batch.y = y_.data();
+        batch.weights = weighted ? weights_.data() : nullptr;
+        batch.offsets = offsets_.data();
+        batch.initial_guesses = initial_guesses;
+        batch.count = count;
+
+        GpuFitOptions gpu;
+        gpu.function_tolerance = options.function_tolerance;
+        gpu.parameter_tolerance = options.parameter_tolerance;
+        gpu.function_tolerance_rel = options.function_tolerance_rel;
+        gpu.parameter_tolerance_rel = options.parameter_tolerance_rel;
+        gpu.initial_simplex_size = options.initial_simplex_size;
+        if (options.adaptive) {
+            // NelderMeadCoefficients::adaptive(6)
+            double n = double(BatchFitResult::ParameterCount);
+            gpu.gamma = 1.0 + 2.0 / n;
+            gpu.rho = 0.75 - 1.0 / (2.0 * n);
+            gpu.sigma = 1.0 - 1.0 / n;
+        }
+        gpu.max_iterations = options.max_iterations;
+        gpu.max_evaluations = options.max_evaluations;
+        fit(batch, results, gpu);
+    }
+
+private:
+    struct DeviceBuffers;
+
+    std::unique_ptr<DeviceBuffers> device_;
+    std::string device_name_;
+
+    // Host staging for the packed SoA batch
+    std::vector<double> x_;
+    std::vector<double> y_;
+    std::vector<double> weights_;
+    std::vector<size_t> offsets_;
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if !defined(__x86_64__) && !defined(__i386__)
+#error "Kernel dispatch builds target x86; build other architectures with -march=native"
+#endif
+
+// Runtime choice of the SIMD kernel path for the portable builds.
+//
+// A dispatch build (-DBENCHMARK_DISPATCH, the Makefile's v2/v3/v4, lto and
+// pgo targets) compiles the harness for a baseline x86-64 level and the
+// Double Gaussian kernels three more times, in KernelsScalar.cpp,
+// KernelsAvx2.cpp and KernelsAvx512.cpp, each with its own -m flags and in its
+// own namespace. Each of those exports a KernelTable of plain function
+// pointers; on first use KernelDispatch picks the widest table the CPU and OS
+// support and GaussianKernels calls through it. The support checks live here,
+// in baseline code, since any function of a wider translation unit may
+// already use instructions the CPU lacks. The indirect call is a few cycles
+// against hundreds of samples per SSR.
+
+// Fast-mode kernels of one instruction set
+struct KernelTable {
+    static constexpr size_t MaxComponents = 8;
+    // Terms of multi_gaussian_ssr: NoBaseline .. ConstantBaseline | LinearBaseline
+    static constexpr size_t BaselineVariants = 4;
+
+    template<typename S>
+    struct Samples {
+        typedef double (*Ssr)(const double* params, const S* x, const S* y, const S* w, size_t count);
+        typedef double (*SsrGrad)(const double* params, const S* x, const S* y, const S* w, size_t count,
+                                  double* grad);
+        typedef double (*NormalEquations)(const double* params, const S* x, const S* y, const S* w,
+                                          size_t count, double* jtj, double* jtr);
+
+        Ssr ssr;
+        SsrGrad ssr_grad;
+        NormalEquations normal_equations;
+        // multi_gaussian_ssr<K, Terms> at multi[K - 1][Terms]
+        Ssr multi[MaxComponents][BaselineVariants];
+    };
+
+    typedef double (*SsrSingle)(const float* params, const float* x, const float* y, const float* w,
+                                size_t count);
+
+    // GaussianKernels::Path of the translation unit
+    const char* path;
+    Samples<double> f64;
+    Samples<float> f32;
+    SsrSingle ssr_single;
+
+    template<typename S>
+    const Samples<S>& samples() const {
+        if constexpr (std::is_same<S, float>::value) return f32;
+        else return f64;
+    }
+};
+
+namespace kernels_scalar { extern const KernelTable table; }
+namespace kernels_avx2 { extern const KernelTable table; }
+namespace kernels_avx512 { extern const KernelTable table; }
+
+class KernelDispatch {
+public:
+    static constexpr size_t TableCount = 3;
+
+    // Table the Fast kernels run through
+    static const KernelTable& kernels() { return *active(); }
+
+    // Tables from widest to narrowest
+    static const KernelTable& table(size_t index) {
+        static const KernelTable* const tables[TableCount] = {
+            &kernels_avx512::table, &kernels_avx2::table, &kernels_scalar::table};
+        return *tables[index];
+    }
+
+    // Whether this CPU and OS can run the table
+    static bool supported(const KernelTable& table) {
+        __builtin_cpu_init();
+        if (&table == &kernels_avx512::table) return __builtin_cpu_supports("avx512f");
+        if (&table == &kernels_avx2::table) return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        return true;
+    }
+
+    // Space-separated paths this CPU supports, widest first
+    static std::string available() {
+        std::string paths;
+        for (size_t i = 0; i < TableCount; i++) {
+            if (!supported(table(i))) continue;
+            if (!paths.empty()) paths += ' ';
+            paths += table(i).path;
+        }
+        return paths;
+    }
+
+    // Runs the named path from now on instead of the widest one, to measure
+    // a narrower tier on this machine. Call before any fit starts.
+    static void select(const std::string& path) {
+        for (size_t i = 0; i < TableCount; i++) {
+            const KernelTable& candidate = table(i);
+            if (path != candidate.path) continue;
+            if (!supported(candidate)) throw std::runtime_error("This CPU cannot run the " + path + " kernels");
+            active() = &candidate;
+            return;
+        }
+        throw std::invalid_argument("Unknown kernel path '" + path + "' (expected avx512, avx2 or scalar)");
+    }
+
+private:
+    static const KernelTable*& active() {
+        static const KernelTable* current = &widest();
+        return current;
+    }
+
+    static const KernelTable& widest() {
+        for (size_t i = 0; i + 1 < TableCount; i++) {
+            if (supported(table(i))) return table(i);
+        }
+        return table(TableCount - 1);
+    }
+};
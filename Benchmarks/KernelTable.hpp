@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#if !defined(GAUSSIAN_KERNELS_NAMESPACE)
+#error "Define GAUSSIAN_KERNELS_NAMESPACE before including KernelTable.hpp"
+#endif
+
+#include "KernelDispatch.hpp"
+#include "GaussianKernels.hpp"
+
+// Body of a per-instruction-set kernel translation unit (Kernels*.cpp, see
+// KernelDispatch.hpp): instantiates the Fast kernels of GaussianKernels.hpp
+// under this file's -m flags, inside GAUSSIAN_KERNELS_NAMESPACE, and exports
+// them as GAUSSIAN_KERNELS_NAMESPACE::table. Nothing outside that namespace
+// may be instantiated here: an inline function emitted from this file would
+// carry its instruction set, and the linker may keep that copy for the whole
+// program.
+namespace GAUSSIAN_KERNELS_NAMESPACE {
+
+static_assert(KernelTable::MaxComponents == GaussianKernels::MaxComponents,
+              "KernelTable needs a multi-Gaussian entry per component count");
+
+template<typename S>
+double ssr(const double* params, const S* x, const S* y, const S* w, size_t count) {
+    return GaussianKernels::double_gaussian_ssr(params, x, y, w, count);
+}
+
+template<typename S>
+double ssr_grad(const double* params, const S* x, const S* y, const S* w, size_t count, double* grad) {
+    return GaussianKernels::double_gaussian_ssr_grad(params, x, y, w, count, grad);
+}
+
+template<typename S>
+double normal_equations(const double* params, const S* x, const S* y, const S* w, size_t count,
+                        double* jtj, double* jtr) {
+    return GaussianKernels::double_gaussian_normal_equations(params, x, y, w, count, jtj, jtr);
+}
+
+template<typename S, size_t K, unsigned Terms>
+double multi_ssr(const double* params, const S* x, const S* y, const S* w, size_t count) {
+    return GaussianKernels::multi_gaussian_ssr<K, Terms>(params, x, y, w, count);
+}
+
+inline double ssr_single(const float* params, const float* x, const float* y, const float* w, size_t count) {
+    return GaussianKernels::double_gaussian_ssr_single(params, x, y, w, count);
+}
+
+template<typename S, size_t... I>
+constexpr KernelTable::Samples<S> samples(std::index_sequence<I...>) {
+    return {ssr<S>, ssr_grad<S>, normal_equations<S>,
+            {{multi_ssr<S, I + 1, NoBaseline>, multi_ssr<S, I + 1, ConstantBaseline>,
+              multi_ssr<S, I + 1, LinearBaseline>, multi_ssr<S, I + 1, ConstantBaseline | LinearBaseline>}...}};
+}
+
+const KernelTable table = {
+    GaussianKernels::Path,
+    samples<double>(std::make_index_sequence<KernelTable::MaxComponents>()),
+    samples<float>(std::make_index_sequence<KernelTable::MaxComponents>()),
+    ssr_single,
+};
+
+}
@@ -0,0 +1,9 @@
+// AVX2 + FMA kernels of the dispatch builds. The Makefile compiles this file
+// with -mavx2 -mfma -mno-avx512f on top of the tier's flags, so the v4 tier
+// still carries a real AVX2 path.
+#if !defined(__AVX2__) || !defined(__FMA__) || defined(__AVX512F__)
+#error "KernelsAvx2.cpp must be compiled with -mavx2 -mfma -mno-avx512f"
+#endif
+
+#define GAUSSIAN_KERNELS_NAMESPACE kernels_avx2
+#include "KernelTable.hpp"
@@ -0,0 +1,8 @@
+// AVX-512 kernels of the dispatch builds. The Makefile compiles this file
+// with -mavx512f -mavx2 -mfma on top of the tier's flags.
+#if !defined(__AVX512F__) || !defined(__FMA__)
+#error "KernelsAvx512.cpp must be compiled with -mavx512f -mavx2 -mfma"
+#endif
+
+#define GAUSSIAN_KERNELS_NAMESPACE kernels_avx512
+#include "KernelTable.hpp"
@@ -0,0 +1,8 @@
+// Scalar kernels of the dispatch builds, for CPUs without AVX2. The Makefile
+// compiles this file with -mno-avx on top of the tier's flags.
+#if defined(__AVX__)
+#error "KernelsScalar.cpp must be compiled with -mno-avx"
+#endif
+
+#define GAUSSIAN_KERNELS_NAMESPACE kernels_scalar
+#include "KernelTable.hpp"
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "NelderMead.hpp"
+
+// Levenberg-Marquardt for fixed-size nonlinear least squares, mirroring
+// Algorithms/LevenbergMarquardt.cs.
+//
+// The problem is supplied as a normal-equations callback that fills J^T W J
+// (N x N, row-major) and J^T W r for r = y - model in a single pass over the
+// data and returns the SSR, so the engine never sees residual vectors or the
+// Jacobian itself. Each iteration solves
+//   (J^T W J + lambda diag(J^T W J)) delta = J^T W r
+// with a fixed-size Cholesky factorization and projects x + delta onto the
+// box bounds. The trial point's normal equations are computed in the same
+// pass as its SSR, so an accepted step costs one pass over the data.
+
+struct LevenbergMarquardtOptions {
+    double function_tolerance = 1e-10;   // relative SSR decrease of an accepted step
+    double parameter_tolerance = 1e-10;  // relative step length
+    double gradient_tolerance = 1e-12;   // max |J^T W r|
+    int max_iterations = 200;
+    double initial_lambda = 1e-3;
+    std::vector<double> lower_bounds;    // empty = unbounded
+    std::vector<double> upper_bounds;    // empty = unbounded
+};
+
+template<size_t N>
+class LevenbergMarquardt {
+public:
+    // Fills jtj (N*N) and jtr (N) at x and returns the SSR
+    typedef double (*NormalEquations)(const double* x, double* jtj, double* jtr, void* data);
+
+    static constexpr size_t ParameterCount = N;
+    static constexpr double LambdaDecrease = 0.1;
+    static constexpr double LambdaIncrease = 10.0;
+    static constexpr double MinLambda = 1e-15;
+    static constexpr double MaxLambda = 1e16;
+    static constexpr double MinDiagonal = 1e-30;
+
+    // Minimizes the SSR starting from initial_guess[0..N). The result is
+    // written to solution[0..N), which may alias initial_guess.
+    OptimizationResult<double> minimize(
+        NormalEquations normal_equations,
+        void* data,
+        const double* initial_guess,
+        double* solution,
+        const LevenbergMarquardtOptions& options = LevenbergMarquardtOptions()) {
+
+        const double* lower = options.lower_bounds.size() >= N ? options.lower_bounds.data() : nullptr;
+        const double* upper = options.upper_bounds.size() >= N ? options.upper_bounds.data() : nullptr;
+
+        Vector x, trial, delta, jtr, trial_jtr;
+        Matrix jtj, trial_jtj, system;
+        std::copy(initial_guess, initial_guess + N, x.begin());
+        project(x, lower, upper);
+
+        OptimizationResult<double> result;
+        double ssr = normal_equations(x.data(), jtj.data(), jtr.data(), data);
+        int function_evaluations = 1;
+        double lambda = options.initial_lambda;
+
+        auto finish = [&](int iterations, bool converged, const char* message) {
+            std::copy(x.begin(), x.end(), solution);
+            result.optimal_value = ssr;
+            result.iterations = iterations;
+            result.function_evaluations = function_evaluations;
+            result.converged = converged;
+            result.message = message;
+            return result;
+        };
+
+        for (int iteration = 0; iteration < options.max_iterations; iteration++) {
+            if (max_abs(jtr) <= options.gradient_tolerance)
+                return finish(iteration, true, "Gradient tolerance reached");
+
+            for (;;) {
+                system = jtj;
+                for (size_t k = 0; k < N; k++)
+                    system[k * N + k] += lambda * std::max(jtj[k * N + k], MinDiagonal);
+
+                if (cholesky_solve(system, jtr, delta)) {
+                    double step_norm = 0.0, x_norm = 0.0;
+                    for (size_t k = 0; k < N; k++) trial[k] = x[k] + delta[k];
+                    project(trial, lower, upper);
+                    for (size_t k = 0; k < N; k++) {
+                        step_norm += (trial[k] - x[k]) * (trial[k] - x[k]);
+                        x_norm += x[k] * x[k];
+                    }
+                    step_norm = std::sqrt(step_norm);
+                    x_norm = std::sqrt(x_norm);
+
+                    double trial_ssr = normal_equations(trial.data(), trial_jtj.data(), trial_jtr.data(), data);
+                    function_evaluations++;
+
+                    if (trial_ssr < ssr) {
+                        double decrease = ssr - trial_ssr;
+                        double previous = ssr;
+                        x = trial;
+                        jtj = trial_jtj;
+                        jtr = trial_jtr;
+                        ssr = trial_ssr;
+                        lambda = std::max(lambda * LambdaDecrease, MinLambda);
+
+                        if (decrease <= options.function_tolerance * previous)
+                            return finish(iteration + 1, true, "Function tolerance reached");
+                        if (step_norm <= options.parameter_tolerance * (x_norm + options.parameter_tolerance))
+                            return finish(iteration + 1, true, "Parameter tolerance reached");
+                        break;
+                    }
+
+                    // A projected step that no longer moves cannot improve
+                    if (step_norm <= options.parameter_tolerance * (x_norm + options.parameter_tolerance))
+                        return finish(iteration + 1, true, "Parameter tolerance reached");
+                }
+
+                lambda *= LambdaIncrease;
+                if (lambda > MaxLambda)
+                    return finish(iteration + 1, false, "Damping limit reached");
+            }
+        }
+
+        return finish(options.max_iterations, false, "Maximum iterations reached");
+    }
+
+private:
+    typedef std::array<double, N> Vector;
+    typedef std::array<double, N * N> Matrix;
+
+    static void project(Vector& x, const double* lower, const double* upper) {
+        for (size_t k = 0; k < N; k++) {
+            if (lower) x[k] = std::max(x[k], lower[k]);
+            if (upper) x[k] = std::min(x[k], upper[k]);
+        }
+    }
+
+    static double max_abs(const Vector& v) {
+        double m = 0.0;
+        for (size_t k = 0; k < N; k++) m = std::max(m, std::abs(v[k]));
+        return m;
+    }
+
+    // Solves a x = b for symmetric positive definite a, factoring in place
+    // (lower triangle). Returns false if a is not positive definite.
+    static bool cholesky_solve(Matrix& a, const Vector& b, Vector& x) {
+        for (size_t j = 0; j < N; j++) {
+            double d = a[j * N + j];
+            for (size_t k = 0; k < j; k++) d -= a[j * N + k] * a[j * N + k];
+            if (!(d > 0.0)) return false;
+            d = std::sqrt(d);
+            a[j * N + j] = d;
+            for (size_t i = j + 1; i < N; i++) {
+                double s = a[i * N + j];
+                for (size_t k = 0; k < j; k++) s -= a[i * N + k] * a[j * N + k];
+                a[i * N + j] = s / d;
+            }
+        }
+        // Forward substitution L y = b, then back substitution L^T x = y
+        for (size_t i = 0; i < N; i++) {
+            double s = b[i];
+            for (size_t k = 0; k < i; k++) s -= a[i * N + k] * x[k];
+            x[i] = s / a[i * N + i];
+        }
+        for (size_t i = N; i-- > 0;) {
+            double s = x[i];
+            for (size_t k = i + 1; k < N; k++) s -= a[k * N + i] * x[k];
+            x[i] = s / a[i * N + i];
+        }
+        return true;
+    }
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "DoubleGaussian.hpp"
+#include "NelderMead.hpp"
+
+// Float32 Double Gaussian fits with an optional polish in double.
+//
+// The first stage runs NelderMead<float> on DoubleGaussianDataF::objective_single:
+// float parameters and model over float samples, so each SIMD step covers
+// twice the samples of the double kernels and reads half the bytes. The
+// solution is good to roughly float resolution of the SSR, which is enough
+// for fits that need ~1e-5 relative accuracy. With polish set, NelderMead<double>
+// restarts from the float solution with a small initial simplex on the
+// double-model objective over the same samples and refines it to the double
+// tolerances, usually in a fraction of the evaluations of a full double fit.
+struct MixedPrecisionOptions {
+    NelderMeadOptions<float> single;
+    NelderMeadOptions<double> polish_options;
+    bool polish = false;
+
+    MixedPrecisionOptions() {
+        // Below the float resolution of typical SSR values the simplex only
+        // chases rounding noise
+        single.function_tolerance = 1e-6f;
+        single.parameter_tolerance = 1e-6f;
+        single.max_iterations = 10000;
+        polish_options.max_iterations = 10000;
+        polish_options.initial_simplex_size = 1e-3;
+    }
+};
+
+struct MixedPrecisionResult {
+    OptimizationResult<double> result;   // totals over both stages; value from the last
+    int single_evaluations = 0;
+    int polish_evaluations = 0;
+};
+
+class MixedPrecisionFitter {
+public:
+    static constexpr size_t ParameterCount = DoubleGaussianDataF::ParameterCount;
+
+    // Fits data from guess into solution (ParameterCount values each)
+    MixedPrecisionResult fit(DoubleGaussianDataF& data, const double* guess, double* solution,
+                             const MixedPrecisionOptions& options = MixedPrecisionOptions()) {
+        float start[ParameterCount];
+        float single_solution[ParameterCount];
+        std::copy(guess, guess + ParameterCount, start);
+        OptimizationResult<float> single = single_.minimize(DoubleGaussianDataF::objective_single, &data, start,
+                                                            ParameterCount, single_solution, options.single);
+        std::copy(single_solution, single_solution + ParameterCount, solution);
+
+        MixedPrecisionResult out;
+        out.single_evaluations = single.function_evaluations;
+        out.result.optimal_value = single.optimal_value;
+        out.result.iterations = single.iterations;
+        out.result.function_evaluations = single.function_evaluations;
+        out.result.converged = single.converged;
+        out.result.message = single.message;
+        if (!options.polish) return out;
+
+        OptimizationResult<double> polished = double_.minimize(DoubleGaussianDataF::objective, &data, solution,
+                                                               ParameterCount, solution, options.polish_options);
+        out.polish_evaluations = polished.function_evaluations;
+        out.result.optimal_value = polished.optimal_value;
+        out.result.iterations += polished.iterations;
+        out.result.function_evaluations += polished.function_evaluations;
+        out.result.converged = polished.converged;
+        out.result.message = polished.message;
+        return out;
+    }
+
+private:
+    NelderMead<float, ParameterCount> single_;
+    NelderMead<double, ParameterCount> double_;
+};
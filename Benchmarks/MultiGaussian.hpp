@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "Dataset.hpp"
+#include "GaussianKernels.hpp"
+#include "ParallelReduction.hpp"
+
+// Mixture of K Gaussians with an optional baseline, fitted over a SoA
+// dataset. Parameters are [A1, mu1, sigma1, ..., AK, muK, sigmaK] followed by
+// the baseline terms selected by Terms (offset, then slope), so K = 2 without
+// a baseline is the Double Gaussian layout. K is a template parameter: the
+// kernel unrolls over the components and NelderMead<double, ParameterCount>
+// gets a fixed-size simplex.
+//
+// exp_mode, pool and parallel_min_size behave as in DoubleGaussianDataset.
+template<size_t K, unsigned Terms = NoBaseline, typename S = double>
+class MultiGaussianDataset {
+public:
+    static_assert(K >= 1 && K <= GaussianKernels::MaxComponents, "MultiGaussian takes 1 to 8 components");
+
+    static constexpr size_t Components = K;
+    static constexpr size_t BaselineCount = ((Terms & ConstantBaseline) ? 1 : 0) + ((Terms & LinearBaseline) ? 1 : 0);
+    static constexpr size_t ParameterCount = 3 * K + BaselineCount;
+    static constexpr size_t ParallelCrossover = 4 * ParallelReduction::ChunkSize;
+
+    Dataset<S> data;
+    ExpMode exp_mode = ExpMode::Fast;
+    ThreadPool* pool = nullptr;
+    size_t parallel_min_size = ParallelCrossover;
+
+    MultiGaussianDataset() = default;
+    explicit MultiGaussianDataset(Dataset<S> samples) : data(std::move(samples)) {}
+
+    size_t size() const { return data.size(); }
+
+    // Reference model evaluation (libm exp), used to generate data
+    static double evaluate(const double* params, double x) {
+        const double* baseline = params + 3 * K;
+        double g = 0.0;
+        if (Terms & ConstantBaseline) g += *baseline++;
+        if (Terms & LinearBaseline) g += *baseline * x;
+        for (size_t k = 0; k < K; k++) {
+            double z = (x - params[3 * k + 1]) / params[3 * k + 2];
+            g += params[3 * k] * std::exp(-0.5 * z * z);
+        }
+        return g;
+    }
+
+    static double objective(const double* params, size_t n, void* data) {
+        MultiGaussianDataset* mgd = static_cast<MultiGaussianDataset*>(data);
+        if (mgd->pool == nullptr || mgd->data.size() < mgd->parallel_min_size)
+            return GaussianKernels::multi_gaussian_ssr<K, Terms>(params, mgd->data, mgd->exp_mode);
+
+        // Same range as the serial kernel: the padding only without a baseline
+        const Dataset<S>& d = mgd->data;
+        size_t count = Terms == NoBaseline ? d.padded_size() : d.size();
+        return ParallelReduction::chunked_sum(*mgd->pool, count, [&](size_t begin, size_t length) {
+            return GaussianKernels::multi_gaussian_ssr<K, Terms>(params, d.x() + begin, d.y() + begin,
+                                                                 d.weighted() ? d.weights() + begin : nullptr,
+                                                                 length, mgd->exp_mode);
+        });
+    }
+};
+
+template<size_t K, unsigned Terms = NoBaseline>
+using MultiGaussian = MultiGaussianDataset<K, Terms, double>;
@@ -0,0 +1,862 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "EvaluationCache.hpp"
+#include "ScratchArena.hpp"
+#include "SolverTrace.hpp"
+
+// Native Nelder-Mead engine mirroring Algorithms/NelderMeadOptimized.cs.
+// The simplex is one flat (n+1)*n buffer addressed through an index array that
+// is kept sorted by function value. All scratch vectors live in a workspace
+// that is sized once and reused across minimize() calls, so the iteration loop
+// never touches the heap.
+//
+// The centroid comes from a running sum of all n+1 vertices: replacing the
+// worst vertex updates the sum in O(n), and the centroid is the sum minus the
+// worst vertex over n. The sum is recomputed from scratch after every shrink
+// (which moves all vertices) and every CentroidRefreshInterval replacements,
+// so rounding drift from the incremental updates stays bounded.
+//
+// Stopping follows NLopt: the function test compares the best and worst
+// vertex values and the parameter test the extent of the simplex along each
+// coordinate, each against an absolute and a relative tolerance (within()).
+// The extent scan is O(n^2), so it runs once every n + 1 replacements and
+// after every shrink and restart rather than every iteration: O(n) per
+// iteration amortized, the same order as the centroid update, at the price
+// of noticing parameter convergence up to n iterations late.
+//
+// The Trace policy (SolverTrace.hpp) receives per-operation and per-phase
+// telemetry; the default NullTrace compiles it away entirely.
+//
+// NelderMead<T, N> fixes the dimension at compile time: the simplex lives in
+// std::arrays inside the engine, every per-coordinate loop (centroid,
+// reflection, expansion, contraction, shrink) is fully unrolled, and the
+// vertices are ordered by a branchless sorting network instead of insertion
+// sort. NelderMead<T> (N = Dynamic) is the runtime-sized engine, and
+// NelderMeadDispatch routes each call to a specialization when one exists for
+// its dimension. Both variants perform the same arithmetic in the same order;
+// only the ordering of vertices with exactly equal values can differ.
+
+// Dimension of the runtime-sized engine
+constexpr size_t Dynamic = 0;
+
+// How NelderMead keeps the simplex inside lower_bounds/upper_bounds. Penalty
+// adds PenaltyFactor * violation^2 to the objective and lets vertices leave
+// the box. Project clamps reflected and expanded trial points onto the box
+// (what NLopt's Nelder-Mead does); Reflect mirrors them back across the
+// violated bound first, then clamps steps longer than the box. Contracted and
+// shrunk points are convex combinations of vertices inside the box, so they
+// stay inside without either.
+enum class BoundsMode { Penalty, Project, Reflect };
+
+template<typename T>
+struct NelderMeadOptions {
+    T function_tolerance = T(1e-8);   // absolute: f(worst) - f(best)
+    T parameter_tolerance = T(1e-8);  // absolute: simplex extent along every coordinate
+    int max_iterations = 1000;
+    std::vector<T> lower_bounds;   // empty = unbounded
+    std::vector<T> upper_bounds;   // empty = unbounded
+    T initial_simplex_size = T(0.05);
+    int parallel_vertices = 1;     // k worst vertices updated per iteration (ParallelNelderMead only)
+    bool adaptive = false;         // Gao-Han coefficients for the dimension (NelderMeadCoefficients)
+    int max_restarts = 0;          // simplex rebuilds around the best vertex (see minimize()); NelderMead only
+    int stall_iterations = 0;      // restart check window in iterations; 0 = 10 n
+    T function_tolerance_rel = T(0);   // NLopt ftol_rel; relative to the mean of |f(best)| and |f(worst)|
+    T parameter_tolerance_rel = T(0);  // NLopt xtol_rel; relative to the coordinate's magnitude
+    int max_evaluations = 0;       // 0 = unlimited; checked once per iteration, so a shrink may overrun by n + 1
+    double max_time = 0.0;         // wall-clock seconds, 0 = unlimited
+    int cache_size = 0;            // EvaluationCache entries (rounded up to a power of two), 0 = off; NelderMead only
+    BoundsMode bounds_mode = BoundsMode::Penalty;
+};
+
+// Expansion, contraction and shrink coefficients (reflection is always 1).
+// standard() is the classic (2, 1/2, 1/2). adaptive(n) is Gao and Han's
+// dimension-dependent set (1 + 2/n, 3/4 - 1/(2n), 1 - 1/n): milder expansion
+// and shrink steps as n grows, which keeps the simplex from flattening in
+// higher dimensions. The two coincide at n = 2; n = 1 uses the n = 2 values.
+template<typename T>
+struct NelderMeadCoefficients {
+    T gamma;
+    T rho;
+    T sigma;
+
+    static NelderMeadCoefficients standard() { return {T(2.0), T(0.5), T(0.5)}; }
+
+    static NelderMeadCoefficients adaptive(size_t n) {
+        T d = T(std::max<size_t>(n, 2));
+        return {T(1) + T(2) / d, T(0.75) - T(1) / (T(2) * d), T(1) - T(1) / d};
+    }
+};
+
+template<typename T>
+struct OptimizationResult {
+    T optimal_value = T(0);
+    int iterations = 0;
+    int function_evaluations = 0;
+    bool converged = false;
+    int restarts = 0;
+    const char* message = "";
+};
+
+// Scratch of the runtime-sized engine: every array, and the evaluation cache,
+// is a block of one arena, so the workspace is a single contiguous
+// allocation with each array on its own cache line. prepare() resets the
+// arena and carves the blocks at the start of every fit.
+template<typename T>
+class NelderMeadWorkspace {
+public:
+    // Arena block addressed like the std::arrays of FixedNelderMeadWorkspace
+    template<typename U>
+    struct Block {
+        U* pointer = nullptr;
+        U* data() const { return pointer; }
+    };
+
+    Block<T> simplex;
+    Block<T> values;
+    Block<int> indices;
+    Block<T> vertex_sum;
+    Block<T> centroid;
+    Block<T> reflected;
+    Block<T> expanded;
+    Block<T> contracted;
+    Block<T> lower_bounds;   // dense bounds, -inf/+inf where absent
+    Block<T> upper_bounds;
+    Block<T> basis;          // n x n, for degenerate()
+    EvaluationCache<T> cache;
+
+    // Bytes of scratch for an n-dimensional fit with a cache_size-entry cache
+    static size_t footprint(size_t n, size_t cache_size) {
+        return ScratchArena::footprint<T>((n + 1) * n) + ScratchArena::footprint<T>(n + 1) +
+               ScratchArena::footprint<int>(n + 1) + 7 * ScratchArena::footprint<T>(n) +
+               ScratchArena::footprint<T>(n * n) +
+               (cache_size > 0 ? EvaluationCache<T>::footprint(cache_size, n) : 0);
+    }
+
+    // Grows the arena for fits up to n dimensions; never shrinks, so a
+    // workspace reused across fits of the same size allocates exactly once.
+    void reserve(size_t n, size_t cache_size = 0) { arena_.reserve(footprint(n, cache_size)); }
+
+    // Releases the previous fit's blocks and carves this fit's
+    void prepare(size_t n, size_t cache_size) {
+        reserve(n, cache_size);
+        arena_.reset();
+        simplex.pointer = arena_.allocate<T>((n + 1) * n);
+        values.pointer = arena_.allocate<T>(n + 1);
+        indices.pointer = arena_.allocate<int>(n + 1);
+        vertex_sum.pointer = arena_.allocate<T>(n);
+        centroid.pointer = arena_.allocate<T>(n);
+        reflected.pointer = arena_.allocate<T>(n);
+        expanded.pointer = arena_.allocate<T>(n);
+        contracted.pointer = arena_.allocate<T>(n);
+        lower_bounds.pointer = arena_.allocate<T>(n);
+        upper_bounds.pointer = arena_.allocate<T>(n);
+        basis.pointer = arena_.allocate<T>(n * n);
+        if (cache_size > 0) cache.reset(cache_size, n, arena_);
+    }
+
+private:
+    ScratchArena arena_;
+};
+
+// Workspace of the fixed-dimension engine; same members as
+// NelderMeadWorkspace so the solver addresses both through data(). Only the
+// evaluation cache, whose size is an option, lives in an arena.
+template<typename T, size_t N>
+class FixedNelderMeadWorkspace {
+public:
+    std::array<T, (N + 1) * N> simplex;
+    std::array<T, N + 1> values;
+    std::array<int, N + 1> indices;
+    std::array<T, N> vertex_sum;
+    std::array<T, N> centroid;
+    std::array<T, N> reflected;
+    std::array<T, N> expanded;
+    std::array<T, N> contracted;
+    std::array<T, N> lower_bounds;
+    std::array<T, N> upper_bounds;
+    std::array<T, N * N> basis;
+    EvaluationCache<T> cache;
+
+    void reserve(size_t, size_t cache_size = 0) {
+        if (cache_size > 0) arena_.reserve(EvaluationCache<T>::footprint(cache_size, N));
+    }
+
+    void prepare(size_t, size_t cache_size) {
+        if (cache_size == 0) return;
+        reserve(N, cache_size);
+        arena_.reset();
+        cache.reset(cache_size, N, arena_);
+    }
+
+private:
+    ScratchArena arena_;
+};
+
+// Batcher odd-even merge sort for Count elements, built for the next power of
+// two with the comparators that touch padding removed: padding sorts as +inf
+// at the top, so those comparators never swap anything.
+template<size_t Count>
+struct SortingNetwork {
+    struct Comparator {
+        int low;
+        int high;
+    };
+
+    static constexpr size_t padded_size() {
+        size_t size = 1;
+        while (size < Count) size <<= 1;
+        return size;
+    }
+
+    // Calls emit(low, high) for each comparator in order and returns how many
+    template<typename Emit>
+    static constexpr size_t generate(Emit emit) {
+        const size_t size = padded_size();
+        size_t count = 0;
+        for (size_t p = 1; p < size; p <<= 1) {
+            for (size_t k = p; k >= 1; k >>= 1) {
+                for (size_t j = k % p; j + k < size; j += 2 * k) {
+                    for (size_t i = 0; i < k && i + j + k < size; i++) {
+                        if ((i + j) / (2 * p) != (i + j + k) / (2 * p)) continue;
+                        if (i + j + k >= Count) continue;
+                        emit(i + j, i + j + k, count);
+                        count++;
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    struct Ignore {
+        constexpr void operator()(size_t, size_t, size_t) const {}
+    };
+
+    struct Store {
+        Comparator* comparators;
+        constexpr void operator()(size_t low, size_t high, size_t index) const {
+            comparators[index] = {static_cast<int>(low), static_cast<int>(high)};
+        }
+    };
+
+    static constexpr size_t Size = generate(Ignore());
+
+    static constexpr std::array<Comparator, Size> build() {
+        std::array<Comparator, Size> comparators = {};
+        generate(Store{comparators.data()});
+        return comparators;
+    }
+
+    static constexpr std::array<Comparator, Size> Comparators = build();
+
+    // Sorts indices[0..Count) by values[index], ascending
+    template<typename T>
+    static void sort(const T* values, int* indices) {
+        apply(values, indices, std::make_index_sequence<Size>());
+    }
+
+private:
+    template<typename T, size_t... I>
+    static void apply(const T* values, int* indices, std::index_sequence<I...>) {
+        (compare_exchange<Comparators[I].low, Comparators[I].high>(values, indices), ...);
+    }
+
+    // Conditional moves rather than a branch: the outcome of each comparison
+    // is close to random from one iteration to the next
+    template<int Low, int High, typename T>
+    static void compare_exchange(const T* values, int* indices) {
+        int a = indices[Low];
+        int b = indices[High];
+        bool swap = values[b] < values[a];
+        indices[Low] = swap ? b : a;
+        indices[High] = swap ? a : b;
+    }
+};
+
+template<typename T>
+class ParallelNelderMead;
+
+template<typename T, size_t N = Dynamic, typename Trace = NullTrace>
+class NelderMead {
+public:
+    static_assert(N + 1 <= 32, "Specialize only small dimensions; use Dynamic above that");
+
+    static constexpr size_t Dimension = N;
+
+    typedef typename std::conditional<N == Dynamic, NelderMeadWorkspace<T>,
+                                      FixedNelderMeadWorkspace<T, N>>::type Workspace;
+
+    // Objective signature: f(x, n, data). Mirrors nlopt::func without the
+    // gradient so raw buffers can be passed straight through.
+    typedef T (*Objective)(const T* x, size_t n, void* data);
+
+    static constexpr T Alpha = T(1.0);   // Reflection
+    static constexpr T Gamma = T(2.0);   // Expansion
+    static constexpr T Rho = T(0.5);     // Contraction
+    static constexpr T Sigma = T(0.5);   // Shrink
+    static constexpr T PenaltyFactor = T(1e6);
+    static constexpr int CentroidRefreshInterval = 100;   // replacements between full re-sums
+    static constexpr T DegenerateRatio = T(1e-4);         // see degenerate()
+
+    NelderMead() = default;
+    explicit NelderMead(size_t max_dimension) { workspace_.reserve(max_dimension); }
+
+    // Minimizes objective starting from initial_guess[0..n). The best vertex is
+    // written to solution[0..n), which may alias initial_guess. A fixed-N
+    // engine only accepts dimension == N.
+    OptimizationResult<T> minimize(
+        Objective objective,
+        void* data,
+        const T* initial_guess,
+        size_t dimension,
+        T* solution,
+        const NelderMeadOptions<T>& options = NelderMeadOptions<T>()) {
+        return minimize([objective, data, dimension](const T* x) { return objective(x, dimension, data); },
+                        initial_guess, dimension, solution, options);
+    }
+
+    // Same for any callable objective(x). The callable's type is a template
+    // argument, so a functor or lambda inlines into the iteration loop where
+    // an Objective pointer costs an indirect call per evaluation.
+    template<typename F, typename = std::enable_if_t<std::is_invocable_r_v<T, F&, const T*>>>
+    OptimizationResult<T> minimize(
+        F&& objective,
+        const T* initial_guess,
+        size_t dimension,
+        T* solution,
+        const NelderMeadOptions<T>& options = NelderMeadOptions<T>()) {
+
+        if (dimension == 0) throw std::invalid_argument("Initial guess cannot be empty");
+        if (N != Dynamic && dimension != N)
+            throw std::invalid_argument("Dimension does not match the specialized engine");
+        // A compile-time constant for fixed N, which is what unrolls the loops below
+        const size_t n = N == Dynamic ? dimension : N;
+        const bool cached = options.cache_size > 0;
+        workspace_.prepare(n, cached ? static_cast<size_t>(options.cache_size) : 0);
+
+        // Bounds become dense arrays, so every check is a branch-free min/max
+        bool has_bounds = !options.lower_bounds.empty() || !options.upper_bounds.empty();
+        const T* lower = nullptr;
+        const T* upper = nullptr;
+        if (has_bounds) {
+            normalize_bounds(options, n, workspace_.lower_bounds.data(), workspace_.upper_bounds.data());
+            lower = workspace_.lower_bounds.data();
+            upper = workspace_.upper_bounds.data();
+        }
+        const bool penalize = has_bounds && options.bounds_mode == BoundsMode::Penalty;
+        const bool confine = has_bounds && !penalize;
+        const bool mirror = options.bounds_mode == BoundsMode::Reflect;
+
+        T* simplex = workspace_.simplex.data();
+        T* values = workspace_.values.data();
+        int* indices = workspace_.indices.data();
+        T* vertex_sum = workspace_.vertex_sum.data();
+        T* centroid = workspace_.centroid.data();
+        T* reflected = workspace_.reflected.data();
+        T* expanded = workspace_.expanded.data();
+        T* contracted = workspace_.contracted.data();
+        const bool track_extent = options.parameter_tolerance > T(0) || options.parameter_tolerance_rel > T(0);
+        const std::chrono::steady_clock::time_point started_at = std::chrono::steady_clock::now();
+
+        // Hits still count as function evaluations, so the operation
+        // accounting is unchanged; the trace reports how many skipped the
+        // objective
+
+        auto evaluate = [&](const T* x) {
+            size_t slot = 0;
+            T value;
+            if (cached) {
+                bool hit = workspace_.cache.lookup(x, slot, value);
+                trace_.cache(hit);
+                if (hit) return value;
+            }
+            uint64_t started = trace_.clock();
+            value = objective(x);
+            trace_.phase(SolverPhase::Objective, started);
+            if (penalize) value += bounds_penalty(x, lower, upper, n);
+            if (cached) workspace_.cache.store(slot, x, value);
+            return value;
+        };
+
+        // Moves a trial point into the box in the confining modes
+        auto to_box = [&](T* x) {
+            if (confine) confine_to_box(x, lower, upper, n, mirror);
+        };
+
+        initialize_simplex(initial_guess, options.initial_simplex_size, lower, upper, simplex, n);
+        for (size_t i = 0; i <= n; i++) to_box(simplex + i * n);
+
+        const NelderMeadCoefficients<T> c = options.adaptive ? NelderMeadCoefficients<T>::adaptive(n)
+                                                             : NelderMeadCoefficients<T>::standard();
+        OptimizationResult<T> result;
+        int function_evaluations = 0;
+        trace_.begin(n);
+
+        // Evaluate initial simplex
+        for (size_t i = 0; i <= n; i++) {
+            values[i] = evaluate(simplex + i * n);
+            indices[i] = static_cast<int>(i);
+            function_evaluations++;
+        }
+        trace_.operation(NelderMeadOperation::Initialize, function_evaluations);
+        sum_vertices(simplex, vertex_sum, n);
+
+        // Replaces the worst vertex and keeps the running vertex sum in step;
+        // extent_due schedules the next parameter test
+        int replacements = 0;
+        bool extent_due = track_extent;
+        auto replace_worst = [&](T* worst_vertex, const T* point) {
+            for_each_coordinate(n, [&](size_t j) {
+                vertex_sum[j] += point[j] - worst_vertex[j];
+                worst_vertex[j] = point[j];
+            });
+            if (++replacements == CentroidRefreshInterval) {
+                sum_vertices(simplex, vertex_sum, n);
+                replacements = 0;
+            }
+            if (replacements % (n + 1) == 0) extent_due = track_extent;
+        };
+
+        // While restarts remain, the simplex is rebuilt around its best vertex
+        // when it has flattened, or when its mean vertex value has moved by
+        // at most the function tolerance over the last window iterations.
+        // Converging also restarts, unless the previous restart already began
+        // from within the function tolerance of the current best:
+        // a simplex that collapsed short of the minimum (false convergence)
+        // then gets a fresh one, and a true minimum costs one extra restart.
+        const int window = options.stall_iterations > 0 ? options.stall_iterations : static_cast<int>(10 * n);
+        int restarts = 0;
+        int window_start = 0;
+        T window_mean = std::numeric_limits<T>::infinity();
+        T restart_value = std::numeric_limits<T>::infinity();
+
+        // The best vertex becomes vertex 0 of a fresh simplex
+        auto restart = [&](int best, int iteration) {
+            std::copy(simplex + best * n, simplex + best * n + n, reflected);
+            T best_value = values[best];
+            restart_value = best_value;
+            initialize_simplex(reflected, options.initial_simplex_size, lower, upper, simplex, n);
+            for (size_t i = 1; i <= n; i++) to_box(simplex + i * n);
+            values[0] = best_value;
+            indices[0] = 0;
+            for (size_t i = 1; i <= n; i++) {
+                values[i] = evaluate(simplex + i * n);
+                indices[i] = static_cast<int>(i);
+                function_evaluations++;
+            }
+            sum_vertices(simplex, vertex_sum, n);
+            replacements = 0;
+            extent_due = track_extent;
+            restarts++;
+            window_start = iteration;
+            window_mean = std::numeric_limits<T>::infinity();
+            trace_.operation(NelderMeadOperation::Restart, static_cast<int>(n));
+        };
+
+        auto finish = [&](int best, int iteration, bool converged, const char* message) {
+            std::copy(simplex + best * n, simplex + best * n + n, solution);
+            result.optimal_value = values[best];
+            result.iterations = iteration;
+            result.function_evaluations = function_evaluations;
+            result.converged = converged;
+            result.restarts = restarts;
+            result.message = message;
+            trace_.end(iteration);
+            return result;
+        };
+
+        for (int iteration = 0; iteration < options.max_iterations; iteration++) {
+            uint64_t started = trace_.clock();
+            sort_vertices(values, indices, n + 1);
+            trace_.phase(SolverPhase::Sort, started);
+
+            int best = indices[0];
+            int worst = indices[n];
+            int second_worst = indices[n - 1];
+            trace_.best(iteration, function_evaluations, double(values[best]));
+
+            // Check convergence
+            bool function_converged = within(values[worst], values[best],
+                                             options.function_tolerance, options.function_tolerance_rel);
+            bool parameters_converged = false;
+            if (!function_converged && extent_due) {
+                extent_due = false;
+                parameters_converged = extent_within(simplex, n, options.parameter_tolerance,
+                                                     options.parameter_tolerance_rel);
+            }
+            if (function_converged || parameters_converged) {
+                if (restarts < options.max_restarts &&
+                    (!within(restart_value, values[best], options.function_tolerance, options.function_tolerance_rel) ||
+                     degenerate(simplex, indices, workspace_.basis.data(), n))) {
+                    restart(best, iteration);
+                    continue;
+                }
+                return finish(best, iteration, true,
+                              function_converged ? "Function tolerance reached" : "Parameter tolerance reached");
+            }
+
+            if (options.max_evaluations > 0 && function_evaluations >= options.max_evaluations)
+                return finish(best, iteration, false, "Maximum evaluations reached");
+            if (options.max_time > 0.0 &&
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count() >= options.max_time)
+                return finish(best, iteration, false, "Maximum time reached");
+
+            if (restarts < options.max_restarts && iteration - window_start >= window) {
+                T mean = T(0);
+                for (size_t i = 0; i <= n; i++) mean += values[i];
+                mean /= T(n + 1);
+                bool stalled = within(window_mean, mean, options.function_tolerance, options.function_tolerance_rel);
+                window_start = iteration;
+                window_mean = mean;
+                if (stalled || degenerate(simplex, indices, workspace_.basis.data(), n)) {
+                    restart(best, iteration);
+                    continue;
+                }
+            }
+
+            T* worst_vertex = simplex + worst * n;
+            started = trace_.clock();
+            calculate_centroid(vertex_sum, worst_vertex, centroid, n);
+            trace_.phase(SolverPhase::Centroid, started);
+
+            // Reflection
+            for_each_coordinate(n, [&](size_t j) {
+                reflected[j] = centroid[j] + Alpha * (centroid[j] - worst_vertex[j]);
+            });
+            to_box(reflected);
+            T reflected_value = evaluate(reflected);
+            function_evaluations++;
+
+            if (values[best] <= reflected_value && reflected_value < values[second_worst]) {
+                replace_worst(worst_vertex, reflected);
+                values[worst] = reflected_value;
+                trace_.operation(NelderMeadOperation::Reflect, 1);
+                continue;
+            }
+
+            if (reflected_value < values[best]) {
+                // Try expansion
+                for_each_coordinate(n, [&](size_t j) {
+                    expanded[j] = centroid[j] + c.gamma * (reflected[j] - centroid[j]);
+                });
+                to_box(expanded);
+                T expanded_value = evaluate(expanded);
+                function_evaluations++;
+
+                if (expanded_value < reflected_value) {
+                    replace_worst(worst_vertex, expanded);
+                    values[worst] = expanded_value;
+                } else {
+                    replace_worst(worst_vertex, reflected);
+                    values[worst] = reflected_value;
+                }
+                trace_.operation(NelderMeadOperation::Expand, 2);
+                continue;
+            }
+
+            // Contraction
+            bool use_reflected = reflected_value < values[worst];
+            const T* contraction_point = use_reflected ? reflected : worst_vertex;
+            for_each_coordinate(n, [&](size_t j) {
+                contracted[j] = centroid[j] + c.rho * (contraction_point[j] - centroid[j]);
+            });
+            T contracted_value = evaluate(contracted);
+            function_evaluations++;
+
+            T comparison_value = use_reflected ? reflected_value : values[worst];
+            if (contracted_value < comparison_value) {
+                replace_worst(worst_vertex, contracted);
+                values[worst] = contracted_value;
+                trace_.operation(use_reflected ? NelderMeadOperation::ContractOutside
+                                               : NelderMeadOperation::ContractInside, 2);
+                continue;
+            }
+
+            // Shrink simplex toward best vertex
+            const T* best_vertex = simplex + best * n;
+            for (size_t i = 1; i <= n; i++) {
+                T* vertex = simplex + indices[i] * n;
+                for_each_coordinate(n, [&](size_t j) {
+                    vertex[j] = best_vertex[j] + c.sigma * (vertex[j] - best_vertex[j]);
+                });
+                values[indices[i]] = evaluate(vertex);
+                function_evaluations++;
+            }
+            sum_vertices(simplex, vertex_sum, n);
+            replacements = 0;
+            extent_due = track_extent;
+            trace_.operation(NelderMeadOperation::Shrink, 2 + static_cast<int>(n));
+        }
+
+        // Return best result found
+        sort_vertices(values, indices, n + 1);
+        return finish(indices[0], options.max_iterations, false, "Maximum iterations reached");
+    }
+
+    const Workspace& workspace() const { return workspace_; }
+
+    // Telemetry of the last minimize() call
+    const Trace& trace() const { return trace_; }
+
+private:
+    // Shares the bounds, initialization, sorting and stopping helpers
+    template<typename> friend class ParallelNelderMead;
+
+    Workspace workspace_;
+    Trace trace_;
+
+    // Runs f(j) for j in [0, n): a plain loop for Dynamic, straight-line code
+    // for fixed N
+    template<typename F>
+    static void for_each_coordinate(size_t n, F&& f) {
+        if constexpr (N == Dynamic) {
+            for (size_t j = 0; j < n; j++) f(j);
+        } else {
+            (void)n;
+            unroll(f, std::make_index_sequence<N>());
+        }
+    }
+
+    template<typename F, size_t... J>
+    static void unroll(F& f, std::index_sequence<J...>) {
+        (f(J), ...);
+    }
+
+    // Copies the bounds into dense n-element arrays, -inf/+inf where a side
+    // is absent or shorter than n
+    static void normalize_bounds(const NelderMeadOptions<T>& options, size_t n, T* lower, T* upper) {
+        for (size_t j = 0; j < n; j++) {
+            lower[j] = j < options.lower_bounds.size() ? options.lower_bounds[j] : -std::numeric_limits<T>::infinity();
+            upper[j] = j < options.upper_bounds.size() ? options.upper_bounds[j] : std::numeric_limits<T>::infinity();
+        }
+    }
+
+    // Quadratic penalty over dense bounds; an absent side contributes
+    // max(-inf, 0) = 0
+    static T bounds_penalty(const T* x, const T* lower, const T* upper, size_t n) {
+        T penalty = T(0);
+        for_each_coordinate(n, [&](size_t j) {
+            T below = std::max(lower[j] - x[j], T(0));
+            T above = std::max(x[j] - upper[j], T(0));
+            penalty += PenaltyFactor * (below * below + above * above);
+        });
+        return penalty;
+    }
+
+    // Project clamps x onto the box; mirror first reflects each coordinate
+    // across the bound it violates (2 lower - x is above x only when x is
+    // below lower), then clamps what still lies outside
+    static void confine_to_box(T* x, const T* lower, const T* upper, size_t n, bool mirror) {
+        for_each_coordinate(n, [&](size_t j) {
+            T value = x[j];
+            if (mirror) {
+                value = std::max(value, T(2) * lower[j] - value);
+                value = std::min(value, T(2) * upper[j] - value);
+            }
+            x[j] = std::min(std::max(value, lower[j]), upper[j]);
+        });
+    }
+
+    // lower and upper are dense bounds, or null when unbounded
+    static void initialize_simplex(const T* initial_guess, T simplex_size,
+                                   const T* lower, const T* upper,
+                                   T* simplex, size_t n) {
+        // First vertex is the initial guess
+        std::copy(initial_guess, initial_guess + n, simplex);
+
+        for (size_t i = 1; i <= n; i++) {
+            T* vertex = simplex + i * n;
+            std::copy(initial_guess, initial_guess + n, vertex);
+
+            size_t param = i - 1;
+            T step = std::abs(initial_guess[param]) * simplex_size;
+            if (step == T(0)) step = simplex_size;
+
+            vertex[param] += step;
+
+            // Ensure bounds are respected
+            if (upper && vertex[param] > upper[param])
+                vertex[param] = initial_guess[param] - step;
+            if (lower && vertex[param] < lower[param])
+                vertex[param] = initial_guess[param] + std::abs(step);
+        }
+    }
+
+    // Insertion sort of vertex indices by value - n+1 is small and the order
+    // changes by one element per iteration, so this is close to linear. Fixed
+    // N uses the sorting network, whose cost does not depend on the data.
+    static void sort_vertices(const T* values, int* indices, size_t count) {
+        if constexpr (N != Dynamic) {
+            (void)count;
+            SortingNetwork<N + 1>::sort(values, indices);
+            return;
+        }
+        for (size_t i = 1; i < count; i++) {
+            int current = indices[i];
+            T current_value = values[current];
+            size_t j = i;
+            while (j > 0 && values[indices[j - 1]] > current_value) {
+                indices[j] = indices[j - 1];
+                j--;
+            }
+            indices[j] = current;
+        }
+    }
+
+    // Sum of all n+1 vertices, from scratch
+    static void sum_vertices(const T* simplex, T* vertex_sum, size_t n) {
+        for_each_coordinate(n, [&](size_t j) { vertex_sum[j] = T(0); });
+        for (size_t i = 0; i <= n; i++) {
+            const T* vertex = simplex + i * n;
+            for_each_coordinate(n, [&](size_t j) { vertex_sum[j] += vertex[j]; });
+        }
+    }
+
+    // True when, along every coordinate, the largest and smallest vertex
+    // coordinates are within the parameter tolerances of each other
+    static bool extent_within(const T* simplex, size_t n, T absolute, T relative) {
+        for (size_t j = 0; j < n; j++) {
+            T lower = simplex[j];
+            T upper = simplex[j];
+            for (size_t i = 1; i <= n; i++) {
+                lower = std::min(lower, simplex[i * n + j]);
+                upper = std::max(upper, simplex[i * n + j]);
+            }
+            if (!within(upper, lower, absolute, relative)) return false;
+        }
+        return true;
+    }
+
+    // NLopt's relstop: new_value is within the absolute or the relative
+    // tolerance of old_value, the latter scaled by the mean of their
+    // magnitudes. An infinite old_value is never within tolerance.
+    static bool within(T old_value, T new_value, T absolute, T relative) {
+        if (std::isinf(old_value)) return false;
+        T change = old_value - new_value;
+        return change <= absolute || change <= relative * (std::abs(old_value) + std::abs(new_value)) * T(0.5);
+    }
+
+    // True when the simplex has flattened. With e_i the edges from the best
+    // vertex, Gram-Schmidt gives the part of each edge orthogonal to the
+    // previous ones; the geometric mean of (orthogonal part / edge length),
+    // (|det E| / prod |e_i|)^(1/n), is about 0.7 for a regular simplex and
+    // tends to 0 as the vertices fall into a hyperplane. O(n^3), so only run
+    // once per restart window. basis is n x n scratch from the workspace.
+    static bool degenerate(const T* simplex, const int* indices, T* basis, size_t n) {
+        const T* best_vertex = simplex + indices[0] * n;
+        T log_ratio = T(0);
+        for (size_t i = 0; i < n; i++) {
+            T* e = basis + i * n;
+            const T* vertex = simplex + indices[i + 1] * n;
+            T length2 = T(0);
+            for (size_t j = 0; j < n; j++) {
+                e[j] = vertex[j] - best_vertex[j];
+                length2 += e[j] * e[j];
+            }
+            for (size_t k = 0; k < i; k++) {
+                const T* q = basis + k * n;
+                T dot = T(0);
+                for (size_t j = 0; j < n; j++) dot += q[j] * e[j];
+                for (size_t j = 0; j < n; j++) e[j] -= dot * q[j];
+            }
+            T norm2 = T(0);
+            for (size_t j = 0; j < n; j++) norm2 += e[j] * e[j];
+            if (!(norm2 > T(0)) || !(length2 > T(0))) return true;
+            T norm = std::sqrt(norm2);
+            log_ratio += std::log(norm / std::sqrt(length2));
+            for (size_t j = 0; j < n; j++) e[j] /= norm;
+        }
+        return log_ratio < T(n) * std::log(DegenerateRatio);
+    }
+
+    // Centroid of every vertex but the worst, in O(n) from the running sum
+    static void calculate_centroid(const T* vertex_sum, const T* worst_vertex, T* centroid, size_t n) {
+        T divisor = T(n);
+        for_each_coordinate(n, [&](size_t j) { centroid[j] = (vertex_sum[j] - worst_vertex[j]) / divisor; });
+    }
+};
+
+// Binds an Objective known at compile time to its data. Passed to the
+// callable minimize() overload, the call resolves statically and inlines.
+template<typename T, T (*F)(const T*, size_t, void*)>
+struct BoundObjective {
+    void* data;
+    size_t n;
+
+    T operator()(const T* x) const { return F(x, n, data); }
+};
+
+// Routes each minimize() call to the NelderMead<T, N> specialization for its
+// dimension and falls back to the runtime-sized engine for any other n.
+template<typename T, size_t... Dims>
+class NelderMeadDispatch {
+public:
+    typedef typename NelderMead<T>::Objective Objective;
+
+    NelderMeadDispatch() = default;
+    explicit NelderMeadDispatch(size_t max_dimension) : dynamic_(max_dimension) {}
+
+    OptimizationResult<T> minimize(
+        Objective objective,
+        void* data,
+        const T* initial_guess,
+        size_t n,
+        T* solution,
+        const NelderMeadOptions<T>& options = NelderMeadOptions<T>()) {
+
+        OptimizationResult<T> result;
+        if (!minimize_fixed(result, objective, data, initial_guess, n, solution, options,
+                            std::index_sequence_for<decltype(Dims)...>()))
+            result = dynamic_.minimize(objective, data, initial_guess, n, solution, options);
+        return result;
+    }
+
+    template<typename F, typename = std::enable_if_t<std::is_invocable_r_v<T, F&, const T*>>>
+    OptimizationResult<T> minimize(
+        F&& objective,
+        const T* initial_guess,
+        size_t n,
+        T* solution,
+        const NelderMeadOptions<T>& options = NelderMeadOptions<T>()) {
+
+        OptimizationResult<T> result;
+        if (!minimize_fixed(result, objective, initial_guess, n, solution, options,
+                            std::index_sequence_for<decltype(Dims)...>()))
+            result = dynamic_.minimize(objective, initial_guess, n, solution, options);
+        return result;
+    }
+
+    static constexpr bool specialized(size_t n) { return ((n == Dims) || ...); }
+
+private:
+    std::tuple<NelderMead<T, Dims>...> fixed_;
+    NelderMead<T> dynamic_;
+
+    template<size_t... I>
+    bool minimize_fixed(OptimizationResult<T>& result, Objective objective, void* data,
+                        const T* initial_guess, size_t n, T* solution,
+                        const NelderMeadOptions<T>& options, std::index_sequence<I...>) {
+        return ((n == Dims && (result = std::get<I>(fixed_).minimize(
+                     objective, data, initial_guess, n, solution, options), true)) || ...);
+    }
+
+    template<typename F, size_t... I>
+    bool minimize_fixed(OptimizationResult<T>& result, F& objective,
+                        const T* initial_guess, size_t n, T* solution,
+                        const NelderMeadOptions<T>& options, std::index_sequence<I...>) {
+        return ((n == Dims && (result = std::get<I>(fixed_).minimize(
+                     objective, initial_guess, n, solution, options), true)) || ...);
+    }
+};
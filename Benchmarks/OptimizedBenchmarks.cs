@@ -19,6 +19,12 @@ public class OptimizedBenchmarks
     private double[] _smallYData = null!;
     private double[] _largeXData = null!;
     private double[] _largeYData = null!;
+    private float[] _xDataFloat = null!;
+    private float[] _yDataFloat = null!;
+    private float[] _initialGuessFloat = null!;
+    private float[] _largeXDataFloat = null!;
+    private float[] _largeYDataFloat = null!;
+    private float[] _parametersFloat = null!;
 
     [GlobalSetup]
     public void Setup()
@@ -56,7 +62,16 @@ public class OptimizedBenchmarks
             _largeYData[i] = DoubleGaussian.Evaluate<double>(trueParams, _largeXData[i]);
         }
 
+        _largeXDataFloat = _largeXData.Select(x => (float)x).ToArray();
+        _largeYDataFloat = _largeYData.Select(y => (float)y).ToArray();
+        _parametersFloat = trueParams.Select(p => (float)p).ToArray();
+
         _initialGuess = DoubleGaussian.GenerateInitialGuess<double>(_xData, _yData).ToArray();
+
+        // Float copies for the precision rows, so their timings exclude the conversion
+        _xDataFloat = _xData.Select(x => (float)x).ToArray();
+        _yDataFloat = _yData.Select(y => (float)y).ToArray();
+        _initialGuessFloat = _initialGuess.Select(g => (float)g).ToArray();
         _options = new NelderMeadOptions<double>
         {
             FunctionTolerance = 1e-8,
@@ -181,11 +196,7 @@ public class OptimizedBenchmarks
     [BenchmarkCategory("Precision")]
     public OptimizationResult<float> FloatOptimization()
     {
-        var xDataFloat = _xData.Select(x => (float)x).ToArray();
-        var yDataFloat = _yData.Select(y => (float)y).ToArray();
-        var guessFloat = _initialGuess.Select(g => (float)g).ToArray();
-        
-        var objective = DoubleGaussianOptimizedFixed.CreateOptimizedObjective<float>(xDataFloat, yDataFloat);
+        var objective = DoubleGaussianOptimizedFixed.CreateOptimizedObjective<float>(_xDataFloat, _yDataFloat);
         
         var optionsFloat = new NelderMeadOptions<float>
         {
@@ -193,7 +204,7 @@ public class OptimizedBenchmarks
             MaxIterations = 1000
         };
         
-        return NelderMeadOptimized<float>.Minimize(objective, guessFloat, optionsFloat);
+        return NelderMeadOptimized<float>.Minimize(objective, _initialGuessFloat, optionsFloat);
     }
 
     [Benchmark]
@@ -205,6 +216,21 @@ public class OptimizedBenchmarks
         return NelderMeadOptimized<double>.Minimize(objective, _initialGuess, _options);
     }
 
+    [Benchmark]
+    [BenchmarkCategory("Precision")]
+    public OptimizationResult<double> MixedPrecisionOptimization()
+    {
+        return DoubleGaussianOptimizedFixed.FitMixedPrecision(_xDataFloat, _yDataFloat, _initialGuess);
+    }
+
+    [Benchmark]
+    [BenchmarkCategory("Precision")]
+    public float LargeSumSquaredResidualsSingle()
+    {
+        return DoubleGaussianOptimizedFixed.SumSquaredResidualsOptimized<float>(
+            _parametersFloat, _largeXDataFloat, _largeYDataFloat);
+    }
+
     // ==================== Small vs Large Dataset ====================
 
     [Benchmark]
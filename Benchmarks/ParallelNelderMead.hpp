@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "NelderMead.hpp"
+#include "ThreadPool.hpp"
+
+// Parallel Nelder-Mead after Lee & Wiswall (2007), for objectives expensive
+// enough that one fit should use several cores (10^5-10^6 samples per
+// dataset).
+//
+// Each iteration reflects the k = options.parallel_vertices worst vertices
+// through the centroid of the n+1-k retained ones. Every reflected vertex then
+// makes the usual expand / contract decision on its own, concurrently on the
+// pool, with the worst retained vertex playing the part of the second-worst.
+// The updates are applied in rank order once all k are done, so the result
+// depends on k but not on the thread count or on scheduling. Only when none of
+// the k vertices improves does the simplex shrink toward the best vertex, and
+// the n shrunk vertices are evaluated in parallel too. With k = 1 this is the
+// sequential algorithm of NelderMead.hpp.
+//
+// The objective is called from several threads at once and must only read
+// from data.
+//
+// Options are NelderMead's: the absolute and relative function and parameter
+// tolerances, max_evaluations and max_time (both checked once per
+// iteration), adaptive coefficients and every BoundsMode. The parameter test
+// runs every iteration, which is cheap next to the objectives this engine is
+// for. Restarts and the evaluation cache are not supported and are rejected.
+
+template<typename T>
+class ParallelNelderMead {
+public:
+    typedef typename NelderMead<T>::Objective Objective;
+
+    explicit ParallelNelderMead(size_t threads = 0) : pool_(threads) {}
+
+    size_t thread_count() const { return pool_.size(); }
+
+    // Same contract as NelderMead::minimize
+    OptimizationResult<T> minimize(
+        Objective objective,
+        void* data,
+        const T* initial_guess,
+        size_t n,
+        T* solution,
+        const NelderMeadOptions<T>& options = NelderMeadOptions<T>()) {
+
+        if (n == 0) throw std::invalid_argument("Initial guess cannot be empty");
+        if (options.max_restarts > 0 || options.cache_size > 0)
+            throw std::invalid_argument("Restarts and the evaluation cache are not supported by ParallelNelderMead");
+        const size_t k = std::min(static_cast<size_t>(std::max(options.parallel_vertices, 1)), n);
+        const size_t retained = n + 1 - k;
+        reserve(n, k);
+
+        bool has_bounds = !options.lower_bounds.empty() || !options.upper_bounds.empty();
+        const T* lower = nullptr;
+        const T* upper = nullptr;
+        if (has_bounds) {
+            Engine::normalize_bounds(options, n, lower_bounds_.data(), upper_bounds_.data());
+            lower = lower_bounds_.data();
+            upper = upper_bounds_.data();
+        }
+        const bool penalize = has_bounds && options.bounds_mode == BoundsMode::Penalty;
+        const bool confine = has_bounds && !penalize;
+        const bool mirror = options.bounds_mode == BoundsMode::Reflect;
+        const bool track_extent = options.parameter_tolerance > T(0) || options.parameter_tolerance_rel > T(0);
+        const NelderMeadCoefficients<T> c = options.adaptive ? NelderMeadCoefficients<T>::adaptive(n)
+                                                             : NelderMeadCoefficients<T>::standard();
+        const std::chrono::steady_clock::time_point started_at = std::chrono::steady_clock::now();
+
+        T* simplex = simplex_.data();
+        T* values = values_.data();
+        int* indices = indices_.data();
+        T* centroid = centroid_.data();
+
+        auto evaluate = [&](const T* x) {
+            T value = objective(x, n, data);
+            if (penalize) value += Engine::bounds_penalty(x, lower, upper, n);
+            return value;
+        };
+
+        // Moves a trial point into the box in the confining modes
+        auto to_box = [&](T* x) {
+            if (confine) Engine::confine_to_box(x, lower, upper, n, mirror);
+        };
+
+        Engine::initialize_simplex(initial_guess, options.initial_simplex_size, lower, upper, simplex, n);
+        for (size_t i = 0; i <= n; i++) to_box(simplex + i * n);
+
+        OptimizationResult<T> result;
+        pool_.parallel_for(n + 1, [&](size_t i, size_t) { values[i] = evaluate(simplex + i * n); });
+        for (size_t i = 0; i <= n; i++) indices[i] = static_cast<int>(i);
+        int function_evaluations = static_cast<int>(n + 1);
+
+        auto finish = [&](int best, int iteration, bool converged, const char* message) {
+            std::copy(simplex + best * n, simplex + best * n + n, solution);
+            result.optimal_value = values[best];
+            result.iterations = iteration;
+            result.function_evaluations = function_evaluations;
+            result.converged = converged;
+            result.message = message;
+            return result;
+        };
+
+        for (int iteration = 0; iteration < options.max_iterations; iteration++) {
+            Engine::sort_vertices(values, indices, n + 1);
+
+            int best = indices[0];
+            int worst = indices[n];
+            T best_value = values[best];
+
+            // Check convergence
+            if (Engine::within(values[worst], best_value, options.function_tolerance, options.function_tolerance_rel))
+                return finish(best, iteration, true, "Function tolerance reached");
+            if (track_extent && Engine::extent_within(simplex, n, options.parameter_tolerance,
+                                                      options.parameter_tolerance_rel))
+                return finish(best, iteration, true, "Parameter tolerance reached");
+            if (options.max_evaluations > 0 && function_evaluations >= options.max_evaluations)
+                return finish(best, iteration, false, "Maximum evaluations reached");
+            if (options.max_time > 0.0 &&
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count() >= options.max_time)
+                return finish(best, iteration, false, "Maximum time reached");
+
+            // Centroid of the retained vertices
+            std::fill(centroid, centroid + n, T(0));
+            for (size_t i = 0; i < retained; i++) {
+                const T* vertex = simplex + indices[i] * n;
+                for (size_t j = 0; j < n; j++)
+                    centroid[j] += vertex[j];
+            }
+            T divisor = T(retained);
+            for (size_t j = 0; j < n; j++)
+                centroid[j] /= divisor;
+
+            T threshold = values[indices[retained - 1]];
+            pool_.parallel_for(k, [&](size_t slot, size_t) {
+                steps_[slot] = update_vertex(evaluate, to_box, c, simplex + indices[retained + slot] * n,
+                                             values[indices[retained + slot]], best_value, threshold,
+                                             trials_.data() + slot * 3 * n, n);
+            });
+
+            bool improved = false;
+            for (size_t slot = 0; slot < k; slot++) {
+                const Step& step = steps_[slot];
+                function_evaluations += step.evaluations;
+                if (!step.accepted) continue;
+                int vertex = indices[retained + slot];
+                std::copy(step.point, step.point + n, simplex + vertex * n);
+                values[vertex] = step.value;
+                improved = true;
+            }
+            if (improved) continue;
+
+            // Shrink simplex toward best vertex
+            const T* best_vertex = simplex + best * n;
+            pool_.parallel_for(n, [&](size_t i, size_t) {
+                int index = indices[i + 1];
+                T* vertex = simplex + index * n;
+                for (size_t j = 0; j < n; j++)
+                    vertex[j] = best_vertex[j] + c.sigma * (vertex[j] - best_vertex[j]);
+                values[index] = evaluate(vertex);
+            });
+            function_evaluations += static_cast<int>(n);
+        }
+
+        // Return best result found
+        Engine::sort_vertices(values, indices, n + 1);
+        return finish(indices[0], options.max_iterations, false, "Maximum iterations reached");
+    }
+
+private:
+    typedef NelderMead<T> Engine;
+
+    // Outcome of one reflected vertex; point is in that slot's trial buffer
+    struct Step {
+        const T* point = nullptr;
+        T value = T(0);
+        int evaluations = 0;
+        bool accepted = false;
+    };
+
+    ThreadPool pool_;
+    std::vector<T> simplex_;
+    std::vector<T> values_;
+    std::vector<int> indices_;
+    std::vector<T> centroid_;
+    std::vector<T> lower_bounds_;   // dense bounds, see NelderMead::normalize_bounds
+    std::vector<T> upper_bounds_;
+    std::vector<T> trials_;   // reflected, expanded, contracted per slot
+    std::vector<Step> steps_;
+
+    void reserve(size_t n, size_t k) {
+        if (centroid_.size() < n) {
+            simplex_.resize((n + 1) * n);
+            values_.resize(n + 1);
+            indices_.resize(n + 1);
+            centroid_.resize(n);
+            lower_bounds_.resize(n);
+            upper_bounds_.resize(n);
+        }
+        if (trials_.size() < k * 3 * n) trials_.resize(k * 3 * n);
+        if (steps_.size() < k) steps_.resize(k);
+    }
+
+    // Reflection, then expansion or contraction of one vertex; reads only the
+    // shared simplex and centroid and writes only its own trial buffer
+    template<typename Evaluate, typename ToBox>
+    Step update_vertex(Evaluate& evaluate, ToBox& to_box, const NelderMeadCoefficients<T>& c, const T* vertex,
+                       T vertex_value, T best_value, T threshold, T* trial, size_t n) const {
+        const T* centroid = centroid_.data();
+        T* reflected = trial;
+        T* expanded = trial + n;
+        T* contracted = trial + 2 * n;
+        Step step;
+
+        for (size_t j = 0; j < n; j++)
+            reflected[j] = centroid[j] + Engine::Alpha * (centroid[j] - vertex[j]);
+        to_box(reflected);
+        T reflected_value = evaluate(reflected);
+        step.evaluations = 1;
+
+        if (best_value <= reflected_value && reflected_value < threshold) {
+            step.point = reflected;
+            step.value = reflected_value;
+            step.accepted = true;
+            return step;
+        }
+
+        if (reflected_value < best_value) {
+            // Try expansion
+            for (size_t j = 0; j < n; j++)
+                expanded[j] = centroid[j] + c.gamma * (reflected[j] - centroid[j]);
+            to_box(expanded);
+            T expanded_value = evaluate(expanded);
+            step.evaluations = 2;
+            step.accepted = true;
+            if (expanded_value < reflected_value) {
+                step.point = expanded;
+                step.value = expanded_value;
+            } else {
+                step.point = reflected;
+                step.value = reflected_value;
+            }
+            return step;
+        }
+
+        // Contraction
+        bool use_reflected = reflected_value < vertex_value;
+        const T* contraction_point = use_reflected ? reflected : vertex;
+        for (size_t j = 0; j < n; j++)
+            contracted[j] = centroid[j] + c.rho * (contraction_point[j] - centroid[j]);
+        T contracted_value = evaluate(contracted);
+        step.evaluations = 2;
+
+        if (contracted_value < (use_reflected ? reflected_value : vertex_value)) {
+            step.point = contracted;
+            step.value = contracted_value;
+            step.accepted = true;
+        }
+        return step;
+    }
+};
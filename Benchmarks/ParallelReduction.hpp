@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "ThreadPool.hpp"
+
+// Deterministic data-parallel sums over large arrays.
+//
+// [0, count) is cut into fixed chunks of ChunkSize elements, each chunk's
+// partial sum lands in its own slot, and the slots are combined by pairwise
+// summation in a fixed tree. The slots live on the caller's stack; past
+// MaxSlots chunks each slot covers a fixed run of consecutive chunks, summed
+// pairwise by the worker that owns it. Chunk boundaries and the tree depend only on
+// count, never on which worker ran which chunk, so the result is bit-identical
+// for every thread count and every run. (It is not bit-identical to one
+// sequential pass over the whole array, whose rounding differs.)
+class ParallelReduction {
+public:
+    // 8192 samples: 128 KiB of double x and y, so a chunk stays in L2 while
+    // its worker streams through it. A multiple of every Dataset padding
+    // multiple, so chunks keep the 64-byte alignment of the arrays.
+    static constexpr size_t ChunkSize = 8192;
+
+    // 4 KiB of slots: one chunk per slot up to 4M samples
+    static constexpr size_t MaxSlots = 512;
+
+    // Sum of chunk(begin, length) over the chunks of [0, count); chunk must
+    // be callable from several pool threads at once
+    template<typename F>
+    static double chunked_sum(ThreadPool& pool, size_t count, F&& chunk) {
+        size_t chunks = (count + ChunkSize - 1) / ChunkSize;
+        if (chunks <= 1) return count ? chunk(size_t(0), count) : 0.0;
+
+        // Slots on this call's stack, so concurrent callers (several solvers
+        // sharing a dataset) do not race and no call allocates
+        double slots[MaxSlots];
+        size_t per_slot = (chunks + MaxSlots - 1) / MaxSlots;
+        size_t used = (chunks + per_slot - 1) / per_slot;
+
+        pool.parallel_for(used, [&](size_t s, size_t) {
+            size_t first = s * per_slot;
+            slots[s] = chunk_range(chunk, count, first, std::min(per_slot, chunks - first));
+        });
+        return pairwise_sum(slots, used);
+    }
+
+    // Fixed-order pairwise summation: error grows with log(count), not count
+    static double pairwise_sum(const double* values, size_t count) {
+        if (count <= 2) return count == 0 ? 0.0 : count == 1 ? values[0] : values[0] + values[1];
+        size_t half = count / 2;
+        return pairwise_sum(values, half) + pairwise_sum(values + half, count - half);
+    }
+
+private:
+    // Pairwise sum of chunks [first, first + chunks) of [0, count)
+    template<typename F>
+    static double chunk_range(F& chunk, size_t count, size_t first, size_t chunks) {
+        if (chunks == 1) {
+            size_t begin = first * ChunkSize;
+            return chunk(begin, std::min(ChunkSize, count - begin));
+        }
+        size_t half = chunks / 2;
+        return chunk_range(chunk, count, first, half) + chunk_range(chunk, count, first + half, chunks - half);
+    }
+};
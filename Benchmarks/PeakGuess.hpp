@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "Dataset.hpp"
+#include "ScratchArena.hpp"
+
+// Data-driven initial guesses for the Double Gaussian model.
+//
+// double_gaussian() smooths y with a running mean, takes the two highest
+// smoothed local maxima separated by a real valley, and estimates each
+// width from its half-maximum crossings and each amplitude by removing the
+// other peak's overlap. When only one peak stands out (a shoulder or a
+// skewed peak), the second component goes on the wider side of it, at least
+// MinSeparation narrow half widths away and MinWidthRatio times as wide, so
+// a symmetric peak does not start two identical components; when that peak
+// has no half-maximum crossing inside the data, the two components are split
+// either side of it with different widths. Work is O(N): one smoothing pass,
+// one scan for maxima and walks out to the half-maximum crossings. The
+// smoothed copy and the maxima are blocks of a caller-owned arena, reset on
+// every call, so a caller that keeps one arena allocates only when a dataset
+// outgrows it.
+//
+// Samples must be sorted by x; otherwise, and for fewer than MinSamples
+// samples, the range heuristic is used instead (peaks at 1/4 and 3/4 of the
+// x range, as DoubleGaussian.GenerateInitialGuess does on the C# side).
+// GeneratePeakInitialGuess in Models/DoubleGaussian.cs is the same algorithm.
+class PeakGuess {
+public:
+    static constexpr size_t ParameterCount = 6;
+    static constexpr size_t MinSamples = 6;
+    static constexpr size_t SmoothingDivisor = 100;   // half window = count / 100
+    static constexpr double ValleyDepth = 0.75;       // valley below this fraction of the lower peak
+    static constexpr double MinRelativeHeight = 0.05; // second peak relative to the first
+    static constexpr double MinSeparation = 0.5;      // single peak: centre offset, in narrow half widths
+    static constexpr double MinWidthRatio = 1.5;      // single peak: wide component over the narrow one
+
+    // guess: [A1, mu1, sigma1, A2, mu2, sigma2] with mu1 <= mu2. scratch is
+    // reset and grown as needed.
+    template<typename S>
+    static void double_gaussian(const S* x, const S* y, size_t count, double* guess, ScratchArena& scratch) {
+        if (count < MinSamples) {
+            range_heuristic(x, y, count, guess);
+            return;
+        }
+
+        // Strict maxima are at least two samples apart, so count / 2 + 1
+        // slots always hold them (or the fallback maximum)
+        size_t max_candidates = count / 2 + 1;
+        scratch.reserve(ScratchArena::footprint<double>(count) + ScratchArena::footprint<Candidate>(max_candidates));
+        scratch.reset();
+        double* s = scratch.allocate<double>(count);
+        if (!smooth(x, y, count, s)) {
+            range_heuristic(x, y, count, guess);
+            return;
+        }
+
+        // Smoothed local maxima, each with the lowest point since the previous one
+        Candidate* candidates = scratch.allocate<Candidate>(max_candidates);
+        size_t candidate_count = 0;
+        size_t valley = 0;
+        for (size_t i = 1; i + 1 < count; i++) {
+            if (s[i] < s[valley]) valley = i;
+            if (s[i] > s[i - 1] && s[i] >= s[i + 1]) {
+                candidates[candidate_count++] = {i, valley};
+                valley = i;
+            }
+        }
+        if (candidate_count == 0) {
+            size_t top = size_t(std::max_element(s, s + count) - s);
+            candidates[candidate_count++] = {top, top};
+        }
+
+        size_t first = 0;
+        for (size_t c = 1; c < candidate_count; c++)
+            if (s[candidates[c].index] > s[candidates[first].index]) first = c;
+        size_t p1 = candidates[first].index;
+
+        // Highest other maximum whose valley towards the first is deep enough
+        size_t p2 = NoPeak, between = NoPeak;
+        size_t low = candidates[first].valley;
+        for (size_t c = first; c-- > 0;) {
+            if (s[candidates[c + 1].valley] < s[low]) low = candidates[c + 1].valley;
+            consider(s, p1, candidates[c].index, low, p2, between);
+        }
+        low = p1;
+        for (size_t c = first + 1; c < candidate_count; c++) {
+            if (s[candidates[c].valley] < s[low]) low = candidates[c].valley;
+            consider(s, p1, candidates[c].index, low, p2, between);
+        }
+
+        double h1 = s[p1];
+        double mu1 = refine(x, s, count, p1);
+        if (p2 != NoPeak) {
+            // Each peak's walk stops at the valley between them
+            HalfWidths w1 = half_widths(x, s, count, p1, p2 < p1 ? between : 0, p2 > p1 ? between : count - 1);
+            HalfWidths w2 = half_widths(x, s, count, p2, p1 < p2 ? between : 0, p1 > p2 ? between : count - 1);
+            double sigma1 = w1.sigma(x[count - 1] - x[0]);
+            double sigma2 = w2.sigma(x[count - 1] - x[0]);
+            double mu2 = refine(x, s, count, p2);
+            store(guess, h1, mu1, sigma1, s[p2], mu2, sigma2);
+            return;
+        }
+
+        // One peak: put the second component on its wider side
+        HalfWidths w = half_widths(x, s, count, p1, 0, count - 1);
+        double range = x[count - 1] - x[0];
+        if (w.left == 0.0 && w.right == 0.0) {
+            // No half-maximum crossing: the peak is broader than the data.
+            // Identical components would start from a degenerate simplex, so
+            // split them by range/8 either side of the peak, the wider one
+            // on the side where the signal is higher
+            double offset = range / 8.0;
+            size_t low = nearest(x, count, p1, mu1 - offset);
+            size_t high = nearest(x, count, p1, mu1 + offset);
+            bool wide_high = s[high] >= s[low];
+            store(guess, s[low] > 0.0 ? s[low] : 0.5 * h1, mu1 - offset, wide_high ? offset : 2.0 * offset,
+                  s[high] > 0.0 ? s[high] : 0.5 * h1, mu1 + offset, wide_high ? 2.0 * offset : offset);
+            return;
+        }
+        double left = w.left > 0.0 ? w.left : w.right;
+        double right = w.right > 0.0 ? w.right : left;
+        double narrow = std::min(left, right);
+        double wide = std::max({left, right, MinWidthRatio * narrow});
+        double side = right >= left ? 1.0 : -1.0;
+        double mu2 = mu1 + side * std::max(wide - narrow, MinSeparation * narrow);
+        size_t i2 = nearest(x, count, p1, mu2);
+        store(guess, h1, mu1, narrow / HalfWidthPerSigma, s[i2] > 0.0 ? s[i2] : 0.5 * h1, mu2,
+              wide / HalfWidthPerSigma);
+    }
+
+    template<typename S>
+    static void double_gaussian(const Dataset<S>& data, double* guess, ScratchArena& scratch) {
+        double_gaussian(data.x(), data.y(), data.size(), guess, scratch);
+    }
+
+    // Peaks at 1/4 and 3/4 of the x range, width 1/8 of it, half the max y each
+    template<typename S>
+    static void range_heuristic(const S* x, const S* y, size_t count, double* guess) {
+        double max_y = 0.0, min_x = count ? double(x[0]) : 0.0, max_x = min_x;
+        for (size_t i = 0; i < count; i++) {
+            max_y = std::max(max_y, double(y[i]));
+            min_x = std::min(min_x, double(x[i]));
+            max_x = std::max(max_x, double(x[i]));
+        }
+        double quarter = (max_x - min_x) / 4.0;
+        double sigma = (max_x - min_x) / 8.0;
+        double amplitude = max_y / 2.0;
+        double values[ParameterCount] = {amplitude, min_x + quarter, sigma, amplitude, min_x + 3.0 * quarter, sigma};
+        std::copy(values, values + ParameterCount, guess);
+    }
+
+private:
+    // Half width at half maximum of a Gaussian, in sigmas: sqrt(2 ln 2)
+    static constexpr double HalfWidthPerSigma = 1.1774100225154747;
+    static constexpr size_t NoPeak = size_t(-1);
+
+    struct Candidate {
+        size_t index;
+        size_t valley;   // lowest smoothed sample between the previous maximum and this one
+    };
+
+    // Distances from the peak to its half-maximum crossings; 0 if none is
+    // reached before the walk limit
+    struct HalfWidths {
+        double left = 0.0;
+        double right = 0.0;
+
+        double sigma(double range) const {
+            double hw = left > 0.0 && right > 0.0 ? 0.5 * (left + right) : std::max(left, right);
+            return hw > 0.0 ? hw / HalfWidthPerSigma : range / 8.0;
+        }
+    };
+
+    // Running mean over 2h+1 samples (clipped at the ends). Returns false if
+    // x is not sorted ascending.
+    template<typename S>
+    static bool smooth(const S* x, const S* y, size_t count, double* s) {
+        size_t h = std::max<size_t>(count / SmoothingDivisor, 1);
+        double sum = 0.0;
+        size_t ahead = std::min(h + 1, count);
+        for (size_t i = 0; i < ahead; i++) sum += double(y[i]);
+        size_t width = ahead;
+        for (size_t i = 0; i < count; i++) {
+            if (i > 0 && x[i] < x[i - 1]) return false;
+            s[i] = sum / double(width);
+            if (i + h + 1 < count) {
+                sum += double(y[i + h + 1]);
+                width++;
+            }
+            if (i >= h) {
+                sum -= double(y[i - h]);
+                width--;
+            }
+        }
+        return true;
+    }
+
+    static void consider(const double* s, size_t p1, size_t candidate, size_t valley, size_t& p2,
+                         size_t& between) {
+        double height = s[candidate];
+        if (height < MinRelativeHeight * s[p1] || s[valley] > ValleyDepth * height) return;
+        if (p2 == NoPeak || height > s[p2]) {
+            p2 = candidate;
+            between = valley;
+        }
+    }
+
+    // Walks out from peak until the smoothed signal falls below half its
+    // height, interpolating the crossing; stops at first and last
+    template<typename S>
+    static HalfWidths half_widths(const S* x, const double* s, size_t count, size_t peak, size_t first,
+                                  size_t last) {
+        HalfWidths w;
+        double half = 0.5 * s[peak];
+        for (size_t i = peak; i > first; i--) {
+            if (s[i - 1] < half) {
+                double t = (half - s[i - 1]) / (s[i] - s[i - 1]);
+                w.left = double(x[peak]) - (double(x[i - 1]) + t * (double(x[i]) - double(x[i - 1])));
+                break;
+            }
+        }
+        for (size_t i = peak; i < last && i + 1 < count; i++) {
+            if (s[i + 1] < half) {
+                double t = (s[i] - half) / (s[i] - s[i + 1]);
+                w.right = double(x[i]) + t * (double(x[i + 1]) - double(x[i])) - double(x[peak]);
+                break;
+            }
+        }
+        return w;
+    }
+
+    // Walks from start towards target and returns the first sample at or
+    // past it, or the end of the data
+    template<typename S>
+    static size_t nearest(const S* x, size_t count, size_t start, double target) {
+        size_t i = start;
+        if (double(x[i]) < target) {
+            while (i + 1 < count && double(x[i]) < target) i++;
+        } else {
+            while (i > 0 && double(x[i]) > target) i--;
+        }
+        return i;
+    }
+
+    // Vertex of the parabola through the peak and its neighbours
+    template<typename S>
+    static double refine(const S* x, const double* s, size_t count, size_t peak) {
+        if (peak == 0 || peak + 1 >= count) return double(x[peak]);
+        double curvature = s[peak - 1] - 2.0 * s[peak] + s[peak + 1];
+        if (curvature >= 0.0) return double(x[peak]);
+        double offset = std::clamp(0.5 * (s[peak - 1] - s[peak + 1]) / curvature, -0.5, 0.5);
+        return double(x[peak]) + offset * 0.5 * (double(x[peak + 1]) - double(x[peak - 1]));
+    }
+
+    // Amplitudes from the smoothed heights at both centres, less the other
+    // peak's contribution there. If the two peaks overlap too much to
+    // separate, each height is shared with the other component by their
+    // overlap instead, so the components do not add up to twice the peak.
+    static void store(double* guess, double h1, double mu1, double sigma1, double h2, double mu2, double sigma2) {
+        double g21 = std::exp(-0.5 * (mu1 - mu2) * (mu1 - mu2) / (sigma2 * sigma2));
+        double g12 = std::exp(-0.5 * (mu2 - mu1) * (mu2 - mu1) / (sigma1 * sigma1));
+        double det = 1.0 - g12 * g21;
+        double a1 = h1 / (1.0 + g21), a2 = h2 / (1.0 + g12);
+        if (det > 1e-3) {
+            double s1 = (h1 - g21 * h2) / det;
+            double s2 = (h2 - g12 * h1) / det;
+            if (s1 > 0.0 && s2 > 0.0) {
+                a1 = s1;
+                a2 = s2;
+            }
+        }
+        double first[3] = {a1, mu1, sigma1};
+        double second[3] = {a2, mu2, sigma2};
+        bool swap = mu2 < mu1;
+        std::copy(swap ? second : first, (swap ? second : first) + 3, guess);
+        std::copy(swap ? first : second, (swap ? first : second) + 3, guess + 3);
+    }
+};
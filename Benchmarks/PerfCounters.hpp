@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters for the calling thread via perf_event_open.
+//
+// Each event is opened on its own (not as a group) with enabled/running
+// times, so when the PMU has fewer counters than events the kernel
+// multiplexes them and the reading is scaled up to the full interval.
+// Events the kernel or the CPU refuses (containers, perf_event_paranoid,
+// virtual machines without a PMU, non-Intel FP events) are simply reported
+// as unavailable; nothing here fails hard.
+//
+// The FP columns use Intel's FP_ARITH_INST_RETIRED (Skylake and later):
+// scalar double/single and packed 128/256/512-bit instructions. An FMA counts
+// as one instruction here, and packed counts are instructions, not lanes.
+
+struct PerfCounterValues {
+    enum Event {
+        Cycles,
+        Instructions,
+        CacheMisses,        // last-level cache
+        L1dReadMisses,
+        BranchMisses,
+        FpScalarOps,
+        FpVectorOps,
+        EventCount
+    };
+
+    double values[EventCount] = {};
+    bool available[EventCount] = {};
+
+    bool any_available() const {
+        for (int e = 0; e < EventCount; e++)
+            if (available[e]) return true;
+        return false;
+    }
+
+    double ipc() const {
+        return available[Cycles] && available[Instructions] && values[Cycles] > 0
+            ? values[Instructions] / values[Cycles] : 0.0;
+    }
+
+    static const char* name(int event) {
+        static const char* const names[EventCount] = {
+            "Cycles", "Instructions", "CacheMisses", "L1dReadMisses", "BranchMisses",
+            "FpScalarOps", "FpVectorOps"
+        };
+        return names[event];
+    }
+};
+
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        open(PerfCounterValues::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open(PerfCounterValues::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open(PerfCounterValues::CacheMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open(PerfCounterValues::L1dReadMisses, PERF_TYPE_HW_CACHE,
+             PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        open(PerfCounterValues::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        if (intel_cpu()) {
+            // FP_ARITH_INST_RETIRED: event 0xC7, umask 0x03 scalar, 0xFC packed
+            open(PerfCounterValues::FpScalarOps, PERF_TYPE_RAW, 0x03C7);
+            open(PerfCounterValues::FpVectorOps, PERF_TYPE_RAW, 0xFCC7);
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int e = 0; e < PerfCounterValues::EventCount; e++)
+            if (fds_[e] >= 0) close(fds_[e]);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const {
+        for (int e = 0; e < PerfCounterValues::EventCount; e++)
+            if (fds_[e] >= 0) return true;
+        return false;
+    }
+
+    void start() {
+#if defined(__linux__)
+        for (int e = 0; e < PerfCounterValues::EventCount; e++) {
+            if (fds_[e] < 0) continue;
+            ioctl(fds_[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds_[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Disables the counters and returns the (multiplexing-scaled) counts
+    // since start(), divided by runs
+    PerfCounterValues stop(size_t runs = 1) {
+        PerfCounterValues result;
+#if defined(__linux__)
+        for (int e = 0; e < PerfCounterValues::EventCount; e++)
+            if (fds_[e] >= 0) ioctl(fds_[e], PERF_EVENT_IOC_DISABLE, 0);
+        for (int e = 0; e < PerfCounterValues::EventCount; e++) {
+            uint64_t reading[3];  // value, time enabled, time running
+            if (fds_[e] < 0 || read(fds_[e], reading, sizeof(reading)) != sizeof(reading)) continue;
+            if (reading[2] == 0) continue;
+            double scaled = double(reading[0]) * double(reading[1]) / double(reading[2]);
+            result.values[e] = scaled / double(runs ? runs : 1);
+            result.available[e] = true;
+        }
+#else
+        (void)runs;
+#endif
+        return result;
+    }
+
+private:
+    int fds_[PerfCounterValues::EventCount] = {-1, -1, -1, -1, -1, -1, -1};
+
+#if defined(__linux__)
+    void open(int event, uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // This thread only, any CPU
+        long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        fds_[event] = fd >= 0 ? static_cast<int>(fd) : -1;
+    }
+
+    static bool intel_cpu() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 9, "vendor_id") == 0)
+                return line.find("GenuineIntel") != std::string::npos;
+        }
+        return false;
+    }
+#endif
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Packed binary output for batch fits, written off the fitting threads.
+//
+// File layout (little-endian):
+//
+//   header    16 bytes   FitResultFileHeader
+//   records   ...        PackedFitResult, 80 bytes each, in completion order
+//
+// Records carry their input index, so completion order does not matter;
+// convert_fit_results.py turns a file into CSV.
+//
+// Workers push into a bounded lock-free ring (one sequence number per slot,
+// after Vyukov's bounded queue) and never touch the file. A background thread
+// drains the ring into a 1 MiB buffer and writes it out with fwrite. A push
+// only waits when the writer has fallen a whole ring behind.
+
+struct FitResultFileHeader {
+    static constexpr uint32_t Magic = 0x52464744;   // "DGFR"
+    static constexpr uint32_t Version = 1;
+
+    uint32_t magic = Magic;
+    uint32_t version = Version;
+    uint32_t record_bytes = 0;
+    uint32_t parameter_count = 0;
+};
+
+struct PackedFitResult {
+    static constexpr size_t ParameterCount = 6;
+    static constexpr uint32_t ConvergedFlag = 1;
+    static constexpr uint32_t WarmStartedFlag = 2;
+
+    uint64_t record;                     // index of the input dataset
+    double parameters[ParameterCount];
+    double final_value;
+    int32_t function_evaluations;
+    int32_t iterations;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FitResultFileHeader) == 16, "Header is four 32-bit words");
+static_assert(sizeof(PackedFitResult) == 80, "Records are packed without padding");
+
+class ResultSink {
+public:
+    static constexpr size_t DefaultCapacity = 1 << 14;   // records in flight
+    static constexpr size_t BufferBytes = 1 << 20;
+
+    explicit ResultSink(const std::string& path, size_t capacity = DefaultCapacity)
+        : mask_(round_up_pow2(capacity) - 1), slots_(new Slot[mask_ + 1]) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (file_ == nullptr) throw std::runtime_error("Cannot create result file " + path);
+        FitResultFileHeader header;
+        header.record_bytes = sizeof(PackedFitResult);
+        header.parameter_count = PackedFitResult::ParameterCount;
+        std::fwrite(&header, sizeof(header), 1, file_);
+
+        for (size_t i = 0; i <= mask_; i++) slots_[i].sequence.store(i, std::memory_order_relaxed);
+        buffer_.reserve(BufferBytes / sizeof(PackedFitResult));
+        writer_ = std::thread([this] { writer_loop(); });
+    }
+
+    // Call close() to see write errors; the destructor swallows them
+    ~ResultSink() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+
+    // Thread-safe and lock-free; spins only while the ring is full
+    void push(const PackedFitResult& result) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[position & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t lag = intptr_t(sequence) - intptr_t(position);
+            if (lag == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = result;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return;
+                }
+            } else if (lag < 0) {
+                // Full: the writer has not freed this slot yet
+                std::this_thread::yield();
+                position = tail_.load(std::memory_order_relaxed);
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Drains the ring, flushes and closes the file. Every push must have
+    // returned before close() is called, and none may follow it.
+    void close() {
+        if (!writer_.joinable()) return;
+        closing_.store(true, std::memory_order_release);
+        writer_.join();
+        bool failed = std::fclose(file_) != 0 || failed_;
+        file_ = nullptr;
+        if (failed) throw std::runtime_error("Writing result file failed");
+    }
+
+    size_t written() const { return written_.load(std::memory_order_relaxed); }
+
+    // Reads a closed result file back, in file order
+    static std::vector<PackedFitResult> read_all(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) throw std::runtime_error("Cannot open result file " + path);
+        FitResultFileHeader header;
+        bool valid = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                     header.magic == FitResultFileHeader::Magic &&
+                     header.version == FitResultFileHeader::Version &&
+                     header.record_bytes == sizeof(PackedFitResult);
+        std::vector<PackedFitResult> results;
+        PackedFitResult record;
+        while (valid && std::fread(&record, sizeof(record), 1, file) == 1) results.push_back(record);
+        std::fclose(file);
+        if (!valid) throw std::runtime_error("Not a result file: " + path);
+        return results;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        PackedFitResult value;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> tail_{0};   // next slot producers claim
+    alignas(64) size_t head_ = 0;               // next slot the writer reads
+    std::atomic<bool> closing_{false};
+    std::atomic<size_t> written_{0};
+    bool failed_ = false;
+    std::FILE* file_ = nullptr;
+    std::vector<PackedFitResult> buffer_;
+    std::thread writer_;
+
+    static size_t round_up_pow2(size_t n) {
+        size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+    // Single consumer: takes the next slot if a producer has published it
+    bool pop(PackedFitResult& result) {
+        Slot& slot = slots_[head_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) return false;
+        result = slot.value;
+        slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        head_++;
+        return true;
+    }
+
+    void writer_loop() {
+        for (;;) {
+            // Read the flag first: anything pushed before close() is then seen
+            bool closing = closing_.load(std::memory_order_acquire);
+            size_t drained = 0;
+            PackedFitResult result;
+            while (buffer_.size() < buffer_.capacity() && pop(result)) {
+                buffer_.push_back(result);
+                drained++;
+            }
+
+            if (buffer_.size() == buffer_.capacity()) {
+                flush();
+            } else if (closing) {
+                flush();
+                return;
+            } else if (drained == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+
+    void flush() {
+        if (std::fwrite(buffer_.data(), sizeof(PackedFitResult), buffer_.size(), file_) != buffer_.size())
+            failed_ = true;
+        written_.fetch_add(buffer_.size(), std::memory_order_relaxed);
+        buffer_.clear();
+    }
+};
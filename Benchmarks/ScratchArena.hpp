@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+// Bump-pointer arena for per-fit scratch. allocate() hands out consecutive
+// cache-line aligned blocks of one buffer and reset() releases them all at
+// once, so an owner that reserves for its largest fit up front serves every
+// later fit without touching the heap. Blocks are raw storage for trivial
+// types: nothing is constructed or destroyed.
+class ScratchArena {
+public:
+    static constexpr size_t Alignment = 64;
+
+    ScratchArena() = default;
+    explicit ScratchArena(size_t bytes) { reserve(bytes); }
+
+    // Bytes allocate<T>(count) takes from the arena; sum these to size
+    // reserve() for a set of blocks
+    template<typename T>
+    static constexpr size_t footprint(size_t count) {
+        return (count * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+    }
+
+    // Grows the buffer to at least bytes; never shrinks. Growing replaces the
+    // buffer and so releases every block, like reset().
+    void reserve(size_t bytes) {
+        if (bytes <= capacity_) return;
+        capacity_ = footprint<unsigned char>(bytes);
+        storage_.reset(new unsigned char[capacity_ + Alignment]);
+        void* base = storage_.get();
+        size_t space = capacity_ + Alignment;
+        base_ = static_cast<unsigned char*>(std::align(Alignment, capacity_, base, space));
+        used_ = 0;
+    }
+
+    // Uninitialized storage for count Ts; throws std::bad_alloc rather than
+    // growing, since growing would invalidate the blocks already handed out
+    template<typename T>
+    T* allocate(size_t count) {
+        size_t bytes = footprint<T>(count);
+        if (bytes > capacity_ - used_) throw std::bad_alloc();
+        T* block = reinterpret_cast<T*>(base_ + used_);
+        used_ += bytes;
+        return block;
+    }
+
+    void reset() { used_ = 0; }
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_; }
+
+private:
+    std::unique_ptr<unsigned char[]> storage_;
+    unsigned char* base_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Opt-in solver telemetry, passed to the engines as a policy type.
+//
+// NullTrace is the default: every hook is an empty inline function, so the
+// untraced engine compiles to the same code as before. SolverTrace counts
+// Nelder-Mead operations and the evaluations they cost, times sorting,
+// centroid computation and the objective, and keeps the best-value history.
+//
+// Each iteration is attributed to the operation it ends in, together with
+// every evaluation it made: Reflect = 1, Expand = 2 (whichever of the expanded
+// and reflected points was kept), ContractOutside/ContractInside = 2,
+// Shrink = 2 + n. Initialize covers the n + 1 starting vertices, Restart the
+// n new vertices of a rebuilt simplex. With an EvaluationCache, every
+// evaluation is also a cache hit or miss; hits are still counted above.
+
+enum class NelderMeadOperation { Initialize, Reflect, Expand, ContractOutside, ContractInside, Shrink, Restart, Count };
+enum class SolverPhase { Sort, Centroid, Objective, Count };
+
+struct NullTrace {
+    static constexpr bool Enabled = false;
+
+    void begin(size_t) {}
+    uint64_t clock() const { return 0; }
+    void phase(SolverPhase, uint64_t) {}
+    void operation(NelderMeadOperation, int) {}
+    void best(int, int, double) {}
+    void cache(bool) {}
+    void end(int) {}
+};
+
+class SolverTrace {
+public:
+    static constexpr bool Enabled = true;
+    static constexpr size_t OperationCount = static_cast<size_t>(NelderMeadOperation::Count);
+    static constexpr size_t PhaseCount = static_cast<size_t>(SolverPhase::Count);
+
+    struct OperationStats {
+        long count = 0;
+        long evaluations = 0;
+    };
+
+    struct HistoryPoint {
+        int iteration;
+        int evaluations;
+        double best_value;
+    };
+
+    // Engine hooks
+    void begin(size_t dimension) {
+        dimension_ = dimension;
+        iterations_ = 0;
+        evaluations_ = 0;
+        for (auto& op : operations_) op = OperationStats();
+        for (auto& ns : phase_ns_) ns = 0;
+        history_.clear();
+        cache_hits_ = 0;
+        cache_misses_ = 0;
+        start_ns_ = clock();
+        total_ns_ = 0;
+    }
+
+    uint64_t clock() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void phase(SolverPhase p, uint64_t start) { phase_ns_[static_cast<size_t>(p)] += clock() - start; }
+
+    void operation(NelderMeadOperation op, int evaluations) {
+        OperationStats& stats = operations_[static_cast<size_t>(op)];
+        stats.count++;
+        stats.evaluations += evaluations;
+        evaluations_ += evaluations;
+    }
+
+    // Records a point only when the best value improves
+    void best(int iteration, int evaluations, double value) {
+        if (history_.empty() || value < history_.back().best_value)
+            history_.push_back({iteration, evaluations, value});
+    }
+
+    void cache(bool hit) {
+        if (hit) cache_hits_++;
+        else cache_misses_++;
+    }
+
+    void end(int iterations) {
+        iterations_ = iterations;
+        total_ns_ = clock() - start_ns_;
+    }
+
+    // Results
+    size_t dimension() const { return dimension_; }
+    int iterations() const { return iterations_; }
+    long evaluations() const { return evaluations_; }
+    const OperationStats& operation_stats(NelderMeadOperation op) const {
+        return operations_[static_cast<size_t>(op)];
+    }
+    double phase_ms(SolverPhase p) const { return phase_ns_[static_cast<size_t>(p)] / 1e6; }
+    double total_ms() const { return total_ns_ / 1e6; }
+    // Everything outside the timed phases: simplex updates, bounds, bookkeeping
+    double other_ms() const {
+        double timed = 0.0;
+        for (size_t p = 0; p < PhaseCount; p++) timed += phase_ns_[p] / 1e6;
+        return total_ms() - timed;
+    }
+    const std::vector<HistoryPoint>& history() const { return history_; }
+    long cache_hits() const { return cache_hits_; }
+    long cache_misses() const { return cache_misses_; }
+
+    static const char* name(NelderMeadOperation op) {
+        static const char* const names[OperationCount] = {
+            "Initialize", "Reflect", "Expand", "ContractOutside", "ContractInside", "Shrink", "Restart"
+        };
+        return names[static_cast<size_t>(op)];
+    }
+
+    static const char* name(SolverPhase p) {
+        static const char* const names[PhaseCount] = {"Sort", "Centroid", "Objective"};
+        return names[static_cast<size_t>(p)];
+    }
+
+    static void write_csv_header(std::ostream& out) {
+        out << "TestName,Record,Name,Count,Evaluations,Time_ms\n";
+    }
+
+    // One row per operation and per phase, then the cache hits and misses
+    void write_csv(std::ostream& out, const std::string& label) const {
+        for (size_t o = 0; o < OperationCount; o++) {
+            NelderMeadOperation op = static_cast<NelderMeadOperation>(o);
+            out << label << ",operation," << name(op) << "," << operations_[o].count << ","
+                << operations_[o].evaluations << ",\n";
+        }
+        for (size_t p = 0; p < PhaseCount; p++) {
+            SolverPhase phase_id = static_cast<SolverPhase>(p);
+            out << label << ",phase," << name(phase_id) << ",,," << phase_ms(phase_id) << "\n";
+        }
+        out << label << ",phase,Other,,," << other_ms() << "\n";
+        out << label << ",cache,Hits," << cache_hits_ << ",,\n";
+        out << label << ",cache,Misses," << cache_misses_ << ",,\n";
+    }
+
+    void write_json(std::ostream& out, const std::string& label) const {
+        out << "{\"test\": \"" << label << "\", \"dimension\": " << dimension_
+            << ", \"iterations\": " << iterations_ << ", \"evaluations\": " << evaluations_
+            << ", \"total_ms\": " << total_ms() << ", \"operations\": {";
+        for (size_t o = 0; o < OperationCount; o++) {
+            out << (o ? ", " : "") << "\"" << name(static_cast<NelderMeadOperation>(o)) << "\": {\"count\": "
+                << operations_[o].count << ", \"evaluations\": " << operations_[o].evaluations << "}";
+        }
+        out << "}, \"phases_ms\": {";
+        for (size_t p = 0; p < PhaseCount; p++) {
+            SolverPhase phase_id = static_cast<SolverPhase>(p);
+            out << (p ? ", " : "") << "\"" << name(phase_id) << "\": " << phase_ms(phase_id);
+        }
+        out << ", \"Other\": " << other_ms() << "}, \"cache\": {\"hits\": " << cache_hits_
+            << ", \"misses\": " << cache_misses_ << "}, \"history\": [";
+        for (size_t i = 0; i < history_.size(); i++) {
+            out << (i ? ", " : "") << "[" << history_[i].iteration << ", " << history_[i].evaluations << ", "
+                << history_[i].best_value << "]";
+        }
+        out << "]}";
+    }
+
+private:
+    size_t dimension_ = 0;
+    int iterations_ = 0;
+    long evaluations_ = 0;
+    OperationStats operations_[OperationCount];
+    uint64_t phase_ns_[PhaseCount] = {};
+    uint64_t start_ns_ = 0;
+    uint64_t total_ns_ = 0;
+    std::vector<HistoryPoint> history_;
+    long cache_hits_ = 0;
+    long cache_misses_ = 0;
+};
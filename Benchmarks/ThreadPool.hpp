@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size pool for data-parallel loops over independent tasks.
+//
+// parallel_for() splits [0, count) into one contiguous range per worker. A
+// worker pops indices from the front of its own range; once empty it steals
+// the back half of the next non-empty range. Fits on noisy spectra vary a lot
+// in cost, so static partitioning alone leaves cores idle at the end of a batch.
+// The calling thread participates as worker 0.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        ranges_.reset(new Range[threads]);
+        worker_count_ = threads;
+        for (size_t w = 1; w < threads; w++)
+            threads_.emplace_back([this, w] { worker_loop(w); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return worker_count_; }
+
+    // Calls body(index, worker) for every index in [0, count). worker is in
+    // [0, size()) and identifies the calling thread, so per-worker state can be
+    // indexed without locking. body must not throw.
+    template<typename F>
+    void parallel_for(size_t count, F&& body) {
+        if (count == 0) return;
+        if (worker_count_ == 1) {
+            for (size_t i = 0; i < count; i++) body(i, size_t(0));
+            return;
+        }
+
+        typedef typename std::remove_reference<F>::type Body;
+        for (size_t w = 0; w < worker_count_; w++) {
+            ranges_[w].begin = count * w / worker_count_;
+            ranges_[w].end = count * (w + 1) / worker_count_;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            job_body_ = &body;
+            job_invoke_ = [](void* b, size_t index, size_t worker) {
+                (*static_cast<Body*>(b))(index, worker);
+            };
+            active_ = worker_count_ - 1;
+            generation_++;
+        }
+        wake_.notify_all();
+
+        run_worker(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        job_body_ = nullptr;
+    }
+
+private:
+    struct alignas(64) Range {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    std::vector<std::thread> threads_;
+    std::unique_ptr<Range[]> ranges_;
+    size_t worker_count_ = 1;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    size_t generation_ = 0;
+    size_t active_ = 0;
+    bool stopping_ = false;
+    void* job_body_ = nullptr;
+    void (*job_invoke_)(void*, size_t, size_t) = nullptr;
+
+    void worker_loop(size_t worker) {
+        size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_) return;
+                seen = generation_;
+            }
+
+            run_worker(worker);
+
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (--active_ == 0) done_.notify_one();
+        }
+    }
+
+    void run_worker(size_t worker) {
+        size_t index;
+        while (pop_own(worker, index) || steal(worker, index))
+            job_invoke_(job_body_, index, worker);
+    }
+
+    bool pop_own(size_t worker, size_t& index) {
+        Range& r = ranges_[worker];
+        std::lock_guard<std::mutex> guard(r.lock);
+        if (r.begin >= r.end) return false;
+        index = r.begin++;
+        return true;
+    }
+
+    bool steal(size_t thief, size_t& index) {
+        for (size_t offset = 1; offset < worker_count_; offset++) {
+            size_t victim = (thief + offset) % worker_count_;
+            size_t begin, end;
+            {
+                Range& v = ranges_[victim];
+                std::lock_guard<std::mutex> guard(v.lock);
+                if (v.begin >= v.end) continue;
+                size_t mid = v.begin + (v.end - v.begin) / 2;
+                begin = mid;
+                end = v.end;
+                v.end = mid;
+            }
+            // Run the first stolen index now and keep the rest as our range
+            index = begin;
+            Range& own = ranges_[thief];
+            std::lock_guard<std::mutex> guard(own.lock);
+            own.begin = begin + 1;
+            own.end = end;
+            return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "Dataset.hpp"
+
+// Warm starts for streams of similar spectra.
+//
+// A SpectrumSignature is a handful of numbers computed in one pass over the
+// samples: x range, the |y|-weighted mean and spread of x, the position and
+// height of the largest |y|, and the area under |y|. WarmStartCache keeps the
+// signatures and solutions of the last few converged fits and returns the
+// solution of the nearest one, if it is within max_distance, to seed the next
+// fit with a smaller initial simplex.
+
+struct WarmStartOptions {
+    bool enabled = false;
+    size_t capacity = 16;            // fits remembered per worker
+    double max_distance = 0.05;      // signature distance still considered similar
+    double simplex_size = 0.01;      // initial_simplex_size for warm-started fits
+};
+
+struct SpectrumSignature {
+    double range = 0.0;
+    double centroid = 0.0;
+    double spread = 0.0;
+    double peak_x = 0.0;
+    double peak_y = 0.0;
+    double area = 0.0;
+
+    template<typename S>
+    static SpectrumSignature of(const Dataset<S>& data) {
+        SpectrumSignature sig;
+        size_t count = data.size();
+        if (count == 0) return sig;
+        const S* x = data.x();
+        const S* y = data.y();
+
+        double x_min = x[0], x_max = x[0];
+        double weight = 0.0, first = 0.0, second = 0.0, peak = -1.0;
+        for (size_t i = 0; i < count; i++) {
+            double xi = double(x[i]);
+            double yi = std::abs(double(y[i]));
+            x_min = std::min(x_min, xi);
+            x_max = std::max(x_max, xi);
+            weight += yi;
+            first += yi * xi;
+            second += yi * xi * xi;
+            if (yi > peak) {
+                peak = yi;
+                sig.peak_x = xi;
+            }
+        }
+
+        sig.range = x_max - x_min;
+        sig.peak_y = peak;
+        sig.area = weight * sig.range / count;
+        if (weight > 0.0) {
+            sig.centroid = first / weight;
+            sig.spread = std::sqrt(std::max(second / weight - sig.centroid * sig.centroid, 0.0));
+        }
+        return sig;
+    }
+
+    // Largest difference of any feature: positions relative to the x range,
+    // heights and areas relative to their size
+    static double distance(const SpectrumSignature& a, const SpectrumSignature& b) {
+        double range = std::max(std::max(a.range, b.range), 1e-300);
+        double d = std::abs(a.range - b.range) / range;
+        d = std::max(d, std::abs(a.centroid - b.centroid) / range);
+        d = std::max(d, std::abs(a.spread - b.spread) / range);
+        d = std::max(d, std::abs(a.peak_x - b.peak_x) / range);
+        d = std::max(d, relative(a.peak_y, b.peak_y));
+        d = std::max(d, relative(a.area, b.area));
+        return d;
+    }
+
+private:
+    static double relative(double a, double b) {
+        double scale = std::max(std::abs(a), std::abs(b));
+        return scale > 0.0 ? std::abs(a - b) / scale : 0.0;
+    }
+};
+
+// Ring of recent fits; not thread-safe, one per worker
+template<size_t ParameterCount>
+class WarmStartCache {
+public:
+    explicit WarmStartCache(size_t capacity = 16) : entries_(std::max<size_t>(capacity, 1)) {}
+
+    void clear() {
+        size_ = 0;
+        next_ = 0;
+    }
+
+    // Solution of the nearest remembered fit within max_distance, or null
+    const double* lookup(const SpectrumSignature& signature, double max_distance) const {
+        const Entry* nearest = nullptr;
+        double nearest_distance = max_distance;
+        for (size_t i = 0; i < size_; i++) {
+            double d = SpectrumSignature::distance(signature, entries_[i].signature);
+            if (d <= nearest_distance) {
+                nearest = &entries_[i];
+                nearest_distance = d;
+            }
+        }
+        return nearest ? nearest->solution : nullptr;
+    }
+
+    // Replaces the oldest entry once full
+    void insert(const SpectrumSignature& signature, const double* solution) {
+        Entry& entry = entries_[next_];
+        entry.signature = signature;
+        std::copy(solution, solution + ParameterCount, entry.solution);
+        next_ = (next_ + 1) % entries_.size();
+        size_ = std::min(size_ + 1, entries_.size());
+    }
+
+private:
+    struct Entry {
+        SpectrumSignature signature;
+        double solution[ParameterCount];
+    };
+
+    std::vector<Entry> entries_;
+    size_t size_ = 0;
+    size_t next_ = 0;
+};
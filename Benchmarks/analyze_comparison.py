@@ -264,6 +264,65 @@ class PerformanceAnalyzer:
         except ImportError:
             print("Matplotlib not available. Install with: pip install matplotlib")
     
+    def create_trace_chart(self, trace_file: str = "solver_trace.json"):
+        """Chart native solver telemetry written by nlopt_benchmark --trace"""
+        if not Path(trace_file).exists():
+            return
+        
+        with open(trace_file, 'r') as f:
+            traces = json.load(f)
+        if not traces:
+            return
+        
+        operations = ['Initialize', 'Reflect', 'Expand', 'ContractOutside', 'ContractInside', 'Shrink', 'Restart']
+        phases = ['Objective', 'Sort', 'Centroid', 'Other']
+        tests = [t['test'] for t in traces]
+        x = np.arange(len(tests))
+        
+        fig, (ax_ops, ax_phases, ax_history) = plt.subplots(3, 1, figsize=(12, 15))
+        
+        # Evaluations spent per operation
+        bottom = np.zeros(len(tests))
+        for op in operations:
+            evals = np.array([t['operations'].get(op, {}).get('evaluations', 0) for t in traces], dtype=float)
+            ax_ops.bar(x, evals, bottom=bottom, label=op)
+            bottom += evals
+        ax_ops.set_ylabel('Function evaluations')
+        ax_ops.set_title('Evaluations by Nelder-Mead operation')
+        ax_ops.set_xticks(x)
+        ax_ops.set_xticklabels(tests, rotation=45, ha='right')
+        ax_ops.legend()
+        
+        # Share of solver time per phase
+        bottom = np.zeros(len(tests))
+        for phase in phases:
+            share = np.array([100.0 * t['phases_ms'][phase] / t['total_ms'] if t['total_ms'] > 0 else 0.0
+                              for t in traces])
+            ax_phases.bar(x, share, bottom=bottom, label=phase)
+            bottom += share
+        ax_phases.set_ylabel('Time (%)')
+        ax_phases.set_title('Solver time by phase')
+        ax_phases.set_xticks(x)
+        ax_phases.set_xticklabels(tests, rotation=45, ha='right')
+        ax_phases.legend()
+        
+        # Best value against evaluations
+        for t in traces:
+            history = [point for point in t['history'] if point[2] > 0]
+            if history:
+                ax_history.plot([p[1] for p in history], [p[2] for p in history], label=t['test'])
+        ax_history.set_xlabel('Function evaluations')
+        ax_history.set_ylabel('Best value')
+        ax_history.set_yscale('log')
+        ax_history.set_title('Convergence history')
+        ax_history.legend(fontsize=8)
+        
+        plt.tight_layout()
+        plt.savefig('solver_trace.png', dpi=150, bbox_inches='tight')
+        plt.close()
+        
+        print("📊 Solver trace chart saved as solver_trace.png")
+    
     def run_analysis(self):
         """Run complete analysis"""
         print("🔍 Analyzing benchmark results...")
@@ -283,6 +342,7 @@ class PerformanceAnalyzer:
         
         # Create chart if possible
         self.create_performance_chart()
+        self.create_trace_chart()
         
         # Print summary to console
         print("\n" + "="*60)
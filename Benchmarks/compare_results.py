@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Compare benchmark results (nlopt_benchmark_results.json) against a baseline and flag regressions
+
+A case regresses when its median is more than --threshold slower and a rank test on the
+per-sample times says the slowdown is significant, or when it stops converging. Samples of
+one run share the machine's state, so record baseline and current runs on the same quiet,
+pinned (--cpu N) machine; the tool warns when the recorded build or CPU differ.
+"""
+
+import argparse
+import json
+import math
+import sys
+from typing import Dict, List, Tuple
+
+SCHEMA_VERSION = 1
+
+# Build and machine fields that must match for timings to be comparable
+ENVIRONMENT_FIELDS = ['cpu_model', 'compiler', 'cxxflags', 'hardware_threads', 'ssr_kernel_path']
+
+
+def load_results(path: str) -> Dict:
+    with open(path) as f:
+        results = json.load(f)
+    if results.get('schema_version') != SCHEMA_VERSION:
+        raise ValueError(f"{path} is not a schema version {SCHEMA_VERSION} result file")
+    return results
+
+
+def keyed_cases(results: Dict) -> Dict[Tuple[str, str], Dict]:
+    """Cases by (test, algorithm); repeats of a pair are numbered in order of appearance"""
+    cases = {}
+    for case in results['results']:
+        key = (case['test'], case['algorithm'])
+        repeat = 2
+        while key in cases:
+            key = (case['test'], f"{case['algorithm']}#{repeat}")
+            repeat += 1
+        cases[key] = case
+    return cases
+
+
+def mann_whitney_greater(current: List[float], baseline: List[float]) -> float:
+    """
+    One-sided p-value of the Mann-Whitney U test that current samples tend to be larger than
+    baseline ones, from the normal approximation with tie correction. Distribution-free, so
+    skewed timing noise does not inflate false alarms the way a t-test would.
+    """
+    n1, n2 = len(current), len(baseline)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+    pooled = sorted([(value, 0) for value in current] + [(value, 1) for value in baseline])
+    ranks = [0.0] * len(pooled)
+    tie_term = 0.0
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1.0
+        ties = j - i + 1
+        tie_term += ties ** 3 - ties
+        i = j + 1
+
+    rank_sum = sum(rank for rank, (_, group) in zip(ranks, pooled) if group == 0)
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))) if n > 1 else 0.0
+    if variance <= 0.0:
+        return 1.0
+    z = (u - n1 * n2 / 2.0 - 0.5) / math.sqrt(variance)   # continuity corrected
+    return 0.5 * math.erfc(z / math.sqrt(2.0))
+
+
+def compare(baseline: Dict, current: Dict, threshold: float, alpha: float) -> Tuple[List[List[str]], int]:
+    """Table rows and the number of regressions"""
+    base_cases = keyed_cases(baseline)
+    current_cases = keyed_cases(current)
+    rows = []
+    regressions = 0
+    for key, case in current_cases.items():
+        base = base_cases.get(key)
+        if base is None:
+            rows.append([key[0], key[1], '', f"{case['timing']['median_ms']:.4f}", '', '', 'new'])
+            continue
+
+        base_ms = base['timing']['median_ms']
+        current_ms = case['timing']['median_ms']
+        change = current_ms / base_ms - 1.0 if base_ms > 0 else 0.0
+        # p-value of the test in the direction the median moved
+        if change >= 0:
+            p_value = mann_whitney_greater(case['timing']['samples_ms'], base['timing']['samples_ms'])
+        else:
+            p_value = mann_whitney_greater(base['timing']['samples_ms'], case['timing']['samples_ms'])
+
+        notes = []
+        if change > threshold and p_value < alpha:
+            notes.append('REGRESSION')
+        elif change < -threshold and p_value < alpha:
+            notes.append('faster')
+        if base['converged'] and not case['converged']:
+            notes.append('NO LONGER CONVERGES')
+        if base['function_evaluations'] != case['function_evaluations']:
+            notes.append(f"evaluations {base['function_evaluations']} -> {case['function_evaluations']}")
+        if 'REGRESSION' in notes or 'NO LONGER CONVERGES' in notes:
+            regressions += 1
+
+        rows.append([key[0], key[1], f"{base_ms:.4f}", f"{current_ms:.4f}", f"{change * 100:+.1f}%",
+                     f"{p_value:.3g}", ', '.join(notes) or 'ok'])
+
+    for key in base_cases:
+        if key not in current_cases:
+            rows.append([key[0], key[1], f"{base_cases[key]['timing']['median_ms']:.4f}", '', '', '', 'missing'])
+    return rows, regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip(),
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('baseline', nargs='?', default='nlopt_baseline.json')
+    parser.add_argument('current', nargs='?', default='nlopt_benchmark_results.json')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='smallest relative change of the median that counts (default 0.05)')
+    parser.add_argument('--alpha', type=float, default=0.01,
+                        help='significance level of the rank test (default 0.01)')
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+    print(f"Baseline: {baseline['git_revision']} ({baseline['timestamp']})")
+    print(f"Current:  {current['git_revision']} ({current['timestamp']})")
+    for field in ENVIRONMENT_FIELDS:
+        if baseline.get(field) != current.get(field):
+            print(f"Warning: {field} differs: {baseline.get(field)!r} vs {current.get(field)!r}")
+
+    rows, regressions = compare(baseline, current, args.threshold, args.alpha)
+    header = ['Test', 'Algorithm', 'Base(ms)', 'Current(ms)', 'Change', 'p', 'Verdict']
+    widths = [max(len(row[i]) for row in rows + [header]) for i in range(len(header))]
+    print()
+    for row in [header] + rows:
+        print('  '.join(cell.ljust(width) for cell, width in zip(row, widths)).rstrip())
+
+    print(f"\n{regressions} regression(s) at {args.threshold:.0%} / alpha {args.alpha}")
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == '__main__':
+    main()
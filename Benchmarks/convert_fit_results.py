@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+Convert packed batch fit results (ResultSink.hpp) to CSV, sorted by record
+"""
+
+import argparse
+import csv
+import struct
+import sys
+from pathlib import Path
+from typing import Dict, List
+
+HEADER = struct.Struct('<4I')          # magic, version, record_bytes, parameter_count
+RECORD = struct.Struct('<Q6ddiiII')    # record, parameters, final value, evals, iterations, flags, reserved
+MAGIC = 0x52464744                     # "DGFR"
+VERSION = 1
+CONVERGED_FLAG = 1
+WARM_STARTED_FLAG = 2
+PARAMETER_NAMES = ['A1', 'Mu1', 'Sigma1', 'A2', 'Mu2', 'Sigma2']
+
+
+def read_fit_results(path: str) -> List[Dict]:
+    """Read a result file into one dict per fit, in record order"""
+    data = Path(path).read_bytes()
+    if len(data) < HEADER.size:
+        raise ValueError(f"{path} is too short to be a result file")
+    magic, version, record_bytes, parameter_count = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError(f"{path} is not a version {VERSION} result file")
+    if record_bytes != RECORD.size or parameter_count != len(PARAMETER_NAMES):
+        raise ValueError(f"{path} has an unexpected record layout")
+
+    fits = []
+    for offset in range(HEADER.size, len(data) - RECORD.size + 1, RECORD.size):
+        values = RECORD.unpack_from(data, offset)
+        fit = {'Record': values[0]}
+        fit.update(zip(PARAMETER_NAMES, values[1:7]))
+        fit['FinalValue'] = values[7]
+        fit['FunctionEvaluations'] = values[8]
+        fit['Iterations'] = values[9]
+        fit['Converged'] = 'true' if values[10] & CONVERGED_FLAG else 'false'
+        fit['WarmStarted'] = 'true' if values[10] & WARM_STARTED_FLAG else 'false'
+        fits.append(fit)
+    fits.sort(key=lambda fit: fit['Record'])
+    return fits
+
+
+def write_csv(fits: List[Dict], out) -> None:
+    columns = (['Record'] + PARAMETER_NAMES +
+               ['FinalValue', 'FunctionEvaluations', 'Iterations', 'Converged', 'WarmStarted'])
+    writer = csv.DictWriter(out, fieldnames=columns, lineterminator='\n')
+    writer.writeheader()
+    for fit in fits:
+        writer.writerow({key: repr(value) if isinstance(value, float) else value for key, value in fit.items()})
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip())
+    parser.add_argument('input', nargs='?', default='batch_fit_results.bin')
+    parser.add_argument('output', nargs='?', default='batch_fit_results.csv', help="'-' for stdout")
+    args = parser.parse_args()
+
+    fits = read_fit_results(args.input)
+    if args.output == '-':
+        write_csv(fits, sys.stdout)
+    else:
+        with open(args.output, 'w', newline='') as out:
+            write_csv(fits, out)
+        print(f"Converted {len(fits)} fits to {args.output}")
+
+
+if __name__ == '__main__':
+    main()
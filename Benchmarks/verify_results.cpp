@@ -1,8 +1,9 @@
 #include <nlopt.hpp>
 #include <iostream>
-#include <chrono>
 #include <vector>
 
+#include "BenchmarkCore.hpp"
+
 // Quick verification of key results
 double sphere5d(const std::vector<double>& x, std::vector<double>& grad, void* data) {
     double sum = 0;
@@ -18,34 +19,28 @@ double rosenbrock(const std::vector<double>& x, std::vector<double>& grad, void*
 }
 
 void benchmark_function(const std::string& name, nlopt::vfunc func, 
-                       const std::vector<double>& start, int runs = 10) {
+                       const std::vector<double>& start, const BenchmarkConfig& config = BenchmarkConfig()) {
     
-    std::vector<double> times;
+    // Configure once; only optimize() is inside the timed runs
+    nlopt::opt opt(nlopt::LN_NELDERMEAD, start.size());
+    opt.set_min_objective(func, nullptr);
+    opt.set_ftol_rel(1e-8);
+    opt.set_xtol_rel(1e-8);
+    opt.set_maxeval(10000);
     
-    for (int i = 0; i < runs; i++) {
-        nlopt::opt opt(nlopt::LN_NELDERMEAD, start.size());
-        opt.set_min_objective(func, nullptr);
-        opt.set_ftol_rel(1e-8);
-        opt.set_xtol_rel(1e-8);
-        opt.set_maxeval(10000);
-        
-        std::vector<double> x = start;
-        double minf;
-        
-        auto start_time = std::chrono::high_resolution_clock::now();
-        nlopt::result result = opt.optimize(x, minf);
-        auto end_time = std::chrono::high_resolution_clock::now();
-        
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-        times.push_back(duration.count() / 1000.0); // Convert to milliseconds
-    }
+    std::vector<double> x;
+    double minf;
     
-    // Calculate average
-    double avg = 0;
-    for (double t : times) avg += t;
-    avg /= times.size();
+    BenchmarkStats stats = BenchmarkRunner::measure([&] {
+        x = start;
+        opt.optimize(x, minf);
+        return 0;
+    }, config);
     
-    std::cout << name << ": " << avg << " ms (average of " << runs << " runs)" << std::endl;
+    std::cout << name << ": median " << stats.median_ms << " ms"
+              << " (95% CI " << stats.median_ci_low_ms << " - " << stats.median_ci_high_ms << ")"
+              << ", min " << stats.min_ms << ", p90 " << stats.p90_ms << ", p99 " << stats.p99_ms
+              << " over " << stats.samples << " samples x " << stats.runs_per_sample << " runs" << std::endl;
 }
 
 int main() {
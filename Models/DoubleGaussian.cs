@@ -114,4 +114,246 @@ public static class DoubleGaussian
 
         return new T[] { amplitude, mu1, sigma, amplitude, mu2, sigma };
     }
+
+    private const int PeakSmoothingDivisor = 100;     // smoothing half window = count / 100
+    private const double PeakValleyDepth = 0.75;      // valley below this fraction of the lower peak
+    private const double PeakMinRelativeHeight = 0.05; // second peak relative to the first
+    private const double PeakMinSeparation = 0.5;     // single peak: centre offset, in narrow half widths
+    private const double PeakMinWidthRatio = 1.5;     // single peak: wide component over the narrow one
+    private const double HalfWidthPerSigma = 1.1774100225154747; // sqrt(2 ln 2)
+
+    /// <summary>
+    /// Initial guess from the shape of the data, in O(N): smooths y with a running mean,
+    /// takes the two highest local maxima separated by a real valley, estimates their widths
+    /// from the half-maximum crossings and their amplitudes net of each other's overlap. With
+    /// only one distinct peak the second component goes on its wider side, offset and widened
+    /// enough that a symmetric peak does not give two identical components, or, when that peak
+    /// has no half-maximum crossing in the data, the two are split either side of it with
+    /// different widths. Samples must be sorted by x; otherwise this falls back to
+    /// <see cref="GenerateInitialGuess{T}"/>.
+    /// Same algorithm as PeakGuess::double_gaussian in the C++ benchmarks.
+    /// </summary>
+    public static ReadOnlySpan<T> GeneratePeakInitialGuess<T>(
+        ReadOnlySpan<T> xData,
+        ReadOnlySpan<T> yData) where T : IFloatingPoint<T>
+    {
+        if (xData.Length != yData.Length || xData.Length < 6)
+            throw new ArgumentException("Need at least 6 data points for double Gaussian fitting");
+
+        int count = xData.Length;
+        var x = new double[count];
+        var s = new double[count];
+        for (int i = 0; i < count; i++)
+        {
+            x[i] = double.CreateChecked(xData[i]);
+            if (i > 0 && x[i] < x[i - 1])
+                return GenerateInitialGuess(xData, yData);
+        }
+
+        // Running mean over 2h+1 samples, clipped at the ends
+        int h = Math.Max(count / PeakSmoothingDivisor, 1);
+        int ahead = Math.Min(h + 1, count);
+        double sum = 0;
+        for (int i = 0; i < ahead; i++) sum += double.CreateChecked(yData[i]);
+        int width = ahead;
+        for (int i = 0; i < count; i++)
+        {
+            s[i] = sum / width;
+            if (i + h + 1 < count)
+            {
+                sum += double.CreateChecked(yData[i + h + 1]);
+                width++;
+            }
+            if (i >= h)
+            {
+                sum -= double.CreateChecked(yData[i - h]);
+                width--;
+            }
+        }
+
+        // Local maxima, each with the lowest point since the previous one
+        var peaks = new List<(int Index, int Valley)>();
+        int valley = 0;
+        for (int i = 1; i + 1 < count; i++)
+        {
+            if (s[i] < s[valley]) valley = i;
+            if (s[i] > s[i - 1] && s[i] >= s[i + 1])
+            {
+                peaks.Add((i, valley));
+                valley = i;
+            }
+        }
+        if (peaks.Count == 0)
+        {
+            int top = 0;
+            for (int i = 1; i < count; i++)
+                if (s[i] > s[top]) top = i;
+            peaks.Add((top, top));
+        }
+
+        int first = 0;
+        for (int c = 1; c < peaks.Count; c++)
+            if (s[peaks[c].Index] > s[peaks[first].Index]) first = c;
+        int p1 = peaks[first].Index;
+
+        // Highest other maximum whose valley towards the first is deep enough
+        int p2 = -1, between = -1;
+        void Consider(int candidate, int low)
+        {
+            double height = s[candidate];
+            if (height < PeakMinRelativeHeight * s[p1] || s[low] > PeakValleyDepth * height) return;
+            if (p2 < 0 || height > s[p2])
+            {
+                p2 = candidate;
+                between = low;
+            }
+        }
+        int lowest = peaks[first].Valley;
+        for (int c = first - 1; c >= 0; c--)
+        {
+            if (s[peaks[c + 1].Valley] < s[lowest]) lowest = peaks[c + 1].Valley;
+            Consider(peaks[c].Index, lowest);
+        }
+        lowest = p1;
+        for (int c = first + 1; c < peaks.Count; c++)
+        {
+            if (s[peaks[c].Valley] < s[lowest]) lowest = peaks[c].Valley;
+            Consider(peaks[c].Index, lowest);
+        }
+
+        double range = x[count - 1] - x[0];
+        double h1 = s[p1];
+        double mu1 = RefinePeak(x, s, p1);
+        T[] guess;
+        if (p2 >= 0)
+        {
+            // Each peak's walk stops at the valley between them
+            var (l1, r1) = HalfWidths(x, s, p1, p2 < p1 ? between : 0, p2 > p1 ? between : count - 1);
+            var (l2, r2) = HalfWidths(x, s, p2, p1 < p2 ? between : 0, p1 > p2 ? between : count - 1);
+            guess = SeparatePeaks<T>(h1, mu1, PeakSigma(l1, r1, range),
+                s[p2], RefinePeak(x, s, p2), PeakSigma(l2, r2, range));
+        }
+        else
+        {
+            // One peak: put the second component on its wider side
+            var (lw, rw) = HalfWidths(x, s, p1, 0, count - 1);
+            if (lw == 0 && rw == 0)
+            {
+                // No half-maximum crossing: the peak is broader than the data. Identical
+                // components would start from a degenerate simplex, so split them by range/8
+                // either side of the peak, the wider one where the signal is higher
+                double offset = range / 8;
+                int low = NearestSample(x, p1, mu1 - offset);
+                int high = NearestSample(x, p1, mu1 + offset);
+                bool wideHigh = s[high] >= s[low];
+                return SeparatePeaks<T>(s[low] > 0 ? s[low] : 0.5 * h1, mu1 - offset, wideHigh ? offset : 2 * offset,
+                    s[high] > 0 ? s[high] : 0.5 * h1, mu1 + offset, wideHigh ? 2 * offset : offset);
+            }
+            double left = lw > 0 ? lw : rw;
+            double right = rw > 0 ? rw : left;
+            double narrow = Math.Min(left, right);
+            double wide = Math.Max(Math.Max(left, right), PeakMinWidthRatio * narrow);
+            double offset = Math.Max(wide - narrow, PeakMinSeparation * narrow);
+            double mu2 = right >= left ? mu1 + offset : mu1 - offset;
+            int i2 = NearestSample(x, p1, mu2);
+            guess = SeparatePeaks<T>(h1, mu1, narrow / HalfWidthPerSigma,
+                s[i2] > 0 ? s[i2] : 0.5 * h1, mu2, wide / HalfWidthPerSigma);
+        }
+        return guess;
+    }
+
+    /// <summary>
+    /// Distances from the peak to its half-maximum crossings, 0 where none is reached
+    /// between first and last
+    /// </summary>
+    private static (double Left, double Right) HalfWidths(double[] x, double[] s, int peak, int first, int last)
+    {
+        double half = 0.5 * s[peak];
+        double left = 0, right = 0;
+        for (int i = peak; i > first; i--)
+        {
+            if (s[i - 1] < half)
+            {
+                double t = (half - s[i - 1]) / (s[i] - s[i - 1]);
+                left = x[peak] - (x[i - 1] + t * (x[i] - x[i - 1]));
+                break;
+            }
+        }
+        for (int i = peak; i < last && i + 1 < x.Length; i++)
+        {
+            if (s[i + 1] < half)
+            {
+                double t = (s[i] - half) / (s[i] - s[i + 1]);
+                right = x[i] + t * (x[i + 1] - x[i]) - x[peak];
+                break;
+            }
+        }
+        return (left, right);
+    }
+
+    /// <summary>
+    /// Walks from start towards target and returns the first sample at or past it, or the end of the data
+    /// </summary>
+    private static int NearestSample(double[] x, int start, double target)
+    {
+        int i = start;
+        if (x[i] < target)
+            while (i + 1 < x.Length && x[i] < target) i++;
+        else
+            while (i > 0 && x[i] > target) i--;
+        return i;
+    }
+
+    private static double PeakSigma(double left, double right, double range)
+    {
+        double halfWidth = left > 0 && right > 0 ? 0.5 * (left + right) : Math.Max(left, right);
+        return halfWidth > 0 ? halfWidth / HalfWidthPerSigma : range / 8;
+    }
+
+    /// <summary>
+    /// Vertex of the parabola through the peak and its neighbours
+    /// </summary>
+    private static double RefinePeak(double[] x, double[] s, int peak)
+    {
+        if (peak == 0 || peak + 1 >= x.Length) return x[peak];
+        double curvature = s[peak - 1] - 2 * s[peak] + s[peak + 1];
+        if (curvature >= 0) return x[peak];
+        double offset = Math.Clamp(0.5 * (s[peak - 1] - s[peak + 1]) / curvature, -0.5, 0.5);
+        return x[peak] + offset * 0.5 * (x[peak + 1] - x[peak - 1]);
+    }
+
+    /// <summary>
+    /// Amplitudes from the smoothed heights at both centres less the other peak's
+    /// contribution there (each height shared by the overlap if the peaks overlap too much
+    /// to separate), ordered by mean
+    /// </summary>
+    private static T[] SeparatePeaks<T>(double h1, double mu1, double sigma1, double h2, double mu2, double sigma2)
+        where T : IFloatingPoint<T>
+    {
+        double g21 = Math.Exp(-0.5 * (mu1 - mu2) * (mu1 - mu2) / (sigma2 * sigma2));
+        double g12 = Math.Exp(-0.5 * (mu2 - mu1) * (mu2 - mu1) / (sigma1 * sigma1));
+        double det = 1 - g12 * g21;
+        double a1 = h1 / (1 + g21), a2 = h2 / (1 + g12);
+        if (det > 1e-3)
+        {
+            double s1 = (h1 - g21 * h2) / det;
+            double s2 = (h2 - g12 * h1) / det;
+            if (s1 > 0 && s2 > 0)
+            {
+                a1 = s1;
+                a2 = s2;
+            }
+        }
+        if (mu2 < mu1)
+        {
+            (a1, a2) = (a2, a1);
+            (mu1, mu2) = (mu2, mu1);
+            (sigma1, sigma2) = (sigma2, sigma1);
+        }
+        return new[]
+        {
+            T.CreateChecked(a1), T.CreateChecked(mu1), T.CreateChecked(sigma1),
+            T.CreateChecked(a2), T.CreateChecked(mu2), T.CreateChecked(sigma2)
+        };
+    }
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 using System.Numerics;
 using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
 using Optimization.Core.Algorithms;
 
 namespace Optimization.Core.Models;
@@ -100,12 +101,15 @@ public static class DoubleGaussianOptimizedFixed
     }
 
     /// <summary>
-    /// Optimized sum of squared residuals with efficient memory usage
+    /// Optimized sum of squared residuals with efficient memory usage. ExpMode.Fast runs the
+    /// Vector&lt;T&gt; kernels with the polynomial exp where SIMD is accelerated; ExpMode.Accurate
+    /// uses Math.Exp for every sample, like ExpMode::Accurate of the native kernels.
     /// </summary>
     public static T SumSquaredResidualsOptimized<T>(
         ReadOnlySpan<T> parameters,
         ReadOnlySpan<T> xData,
-        ReadOnlySpan<T> yData) where T : unmanaged, IFloatingPoint<T>
+        ReadOnlySpan<T> yData,
+        ExpMode expMode = ExpMode.Fast) where T : unmanaged, IFloatingPoint<T>
     {
         if (xData.Length != yData.Length)
             throw new ArgumentException("X and Y data must have the same length");
@@ -113,6 +117,29 @@ public static class DoubleGaussianOptimizedFixed
         if (parameters.Length != 6)
             throw new ArgumentException("Double Gaussian requires exactly 6 parameters");
 
+        if (expMode == ExpMode.Accurate)
+            return SumSquaredResidualsInline(parameters, xData, yData);
+
+        // SIMD path for double precision, matching the native GaussianKernels SSR kernel
+        if (typeof(T) == typeof(double) && Vector.IsHardwareAccelerated && xData.Length >= Vector<double>.Count)
+        {
+            double ssr = SumSquaredResidualsVector(
+                MemoryMarshal.Cast<T, double>(parameters),
+                MemoryMarshal.Cast<T, double>(xData),
+                MemoryMarshal.Cast<T, double>(yData));
+            return T.CreateChecked(ssr);
+        }
+
+        // Float32 SIMD path: twice the lanes, squared residuals summed in double
+        if (typeof(T) == typeof(float) && Vector.IsHardwareAccelerated && xData.Length >= Vector<float>.Count)
+        {
+            double ssr = SumSquaredResidualsVectorSingle(
+                MemoryMarshal.Cast<T, float>(parameters),
+                MemoryMarshal.Cast<T, float>(xData),
+                MemoryMarshal.Cast<T, float>(yData));
+            return T.CreateChecked(ssr);
+        }
+
         // For small datasets, use direct calculation to avoid allocation
         if (xData.Length <= 64)
         {
@@ -133,6 +160,201 @@ public static class DoubleGaussianOptimizedFixed
         return CalculateResiduals(yData, predictedLarge);
     }
 
+    /// <summary>
+    /// Vector&lt;double&gt; SSR kernel evaluating both Gaussians Vector&lt;double&gt;.Count samples at a time
+    /// </summary>
+    private static double SumSquaredResidualsVector(
+        ReadOnlySpan<double> parameters,
+        ReadOnlySpan<double> xData,
+        ReadOnlySpan<double> yData)
+    {
+        double a1 = parameters[0];
+        double mu1 = parameters[1];
+        double sigma1 = parameters[2];
+        double a2 = parameters[3];
+        double mu2 = parameters[4];
+        double sigma2 = parameters[5];
+
+        if (sigma1 <= 0.0) sigma1 = MinSigma;
+        if (sigma2 <= 0.0) sigma2 = MinSigma;
+
+        var vA1 = new Vector<double>(a1);
+        var vMu1 = new Vector<double>(mu1);
+        var vInv1 = new Vector<double>(1.0 / sigma1);
+        var vA2 = new Vector<double>(a2);
+        var vMu2 = new Vector<double>(mu2);
+        var vInv2 = new Vector<double>(1.0 / sigma2);
+        var vNegHalf = new Vector<double>(NegativeHalf);
+        var accumulator = Vector<double>.Zero;
+
+        int width = Vector<double>.Count;
+        int i = 0;
+        for (; i <= xData.Length - width; i += width)
+        {
+            var x = new Vector<double>(xData.Slice(i, width));
+            var norm1 = (x - vMu1) * vInv1;
+            var norm2 = (x - vMu2) * vInv2;
+            var predicted = vA1 * ExpPolynomial(vNegHalf * norm1 * norm1)
+                          + vA2 * ExpPolynomial(vNegHalf * norm2 * norm2);
+            var residual = new Vector<double>(yData.Slice(i, width)) - predicted;
+            accumulator += residual * residual;
+        }
+
+        double sumSquaredError = Vector.Sum(accumulator);
+
+        // Tail: one more vector step over the remaining samples, so they use the same exp
+        if (i < xData.Length)
+        {
+            Span<double> tail = stackalloc double[width];
+            tail.Fill(mu1);
+            xData.Slice(i).CopyTo(tail);
+            var x = new Vector<double>(tail);
+            var norm1 = (x - vMu1) * vInv1;
+            var norm2 = (x - vMu2) * vInv2;
+            var predicted = vA1 * ExpPolynomial(vNegHalf * norm1 * norm1)
+                          + vA2 * ExpPolynomial(vNegHalf * norm2 * norm2);
+            for (int j = 0; i + j < xData.Length; j++)
+            {
+                double residual = yData[i + j] - predicted[j];
+                sumSquaredError += residual * residual;
+            }
+        }
+
+        return sumSquaredError;
+    }
+
+    /// <summary>
+    /// Polynomial exp for Vector&lt;double&gt;: Cody-Waite reduction to |r| &lt;= ln2/2 and a degree-13
+    /// Taylor series. Relative error stays within 1 ulp of Math.Exp on [-708, 0]; inputs below -708 return 0.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    internal static Vector<double> ExpPolynomial(Vector<double> x)
+    {
+        var underflow = Vector.LessThan(x, new Vector<double>(-708.0));
+        x = Vector.Max(x, new Vector<double>(-708.0));
+
+        var k = Vector.Floor(x * new Vector<double>(1.4426950408889634) + new Vector<double>(0.5));
+        var r = x - k * new Vector<double>(6.93147180369123816490e-01);
+        r -= k * new Vector<double>(1.90821492927058770002e-10);
+
+        var p = new Vector<double>(1.0 / 6227020800.0);
+        p = p * r + new Vector<double>(1.0 / 479001600.0);
+        p = p * r + new Vector<double>(1.0 / 39916800.0);
+        p = p * r + new Vector<double>(1.0 / 3628800.0);
+        p = p * r + new Vector<double>(1.0 / 362880.0);
+        p = p * r + new Vector<double>(1.0 / 40320.0);
+        p = p * r + new Vector<double>(1.0 / 5040.0);
+        p = p * r + new Vector<double>(1.0 / 720.0);
+        p = p * r + new Vector<double>(1.0 / 120.0);
+        p = p * r + new Vector<double>(1.0 / 24.0);
+        p = p * r + new Vector<double>(1.0 / 6.0);
+        p = p * r + new Vector<double>(0.5);
+        p = p * r + Vector<double>.One;
+        p = p * r + Vector<double>.One;
+
+        // 2^k assembled directly in the exponent field
+        var bits = Vector.ShiftLeft(Vector.ConvertToInt64(k) + new Vector<long>(1023), 52);
+        var result = p * Vector.AsVectorDouble(bits);
+        return Vector.ConditionalSelect(underflow, Vector<double>.Zero, result);
+    }
+
+    /// <summary>
+    /// Vector&lt;float&gt; SSR kernel: model and residuals in float, Vector&lt;float&gt;.Count samples at
+    /// a time, with the squared residuals widened to double before they are summed so long
+    /// datasets keep their digits. Matches GaussianKernels::double_gaussian_ssr_single.
+    /// </summary>
+    private static double SumSquaredResidualsVectorSingle(
+        ReadOnlySpan<float> parameters,
+        ReadOnlySpan<float> xData,
+        ReadOnlySpan<float> yData)
+    {
+        float a1 = parameters[0];
+        float mu1 = parameters[1];
+        float sigma1 = parameters[2];
+        float a2 = parameters[3];
+        float mu2 = parameters[4];
+        float sigma2 = parameters[5];
+
+        if (sigma1 <= 0f) sigma1 = (float)MinSigma;
+        if (sigma2 <= 0f) sigma2 = (float)MinSigma;
+
+        var vA1 = new Vector<float>(a1);
+        var vMu1 = new Vector<float>(mu1);
+        var vInv1 = new Vector<float>(1f / sigma1);
+        var vA2 = new Vector<float>(a2);
+        var vMu2 = new Vector<float>(mu2);
+        var vInv2 = new Vector<float>(1f / sigma2);
+        var vNegHalf = new Vector<float>(-0.5f);
+        var low = Vector<double>.Zero;
+        var high = Vector<double>.Zero;
+
+        int width = Vector<float>.Count;
+        int i = 0;
+        for (; i <= xData.Length - width; i += width)
+        {
+            var x = new Vector<float>(xData.Slice(i, width));
+            var norm1 = (x - vMu1) * vInv1;
+            var norm2 = (x - vMu2) * vInv2;
+            var predicted = vA1 * ExpPolynomialSingle(vNegHalf * norm1 * norm1)
+                          + vA2 * ExpPolynomialSingle(vNegHalf * norm2 * norm2);
+            var residual = new Vector<float>(yData.Slice(i, width)) - predicted;
+            Vector.Widen(residual * residual, out var squaredLow, out var squaredHigh);
+            low += squaredLow;
+            high += squaredHigh;
+        }
+
+        double sumSquaredError = Vector.Sum(low + high);
+
+        // Tail: one more vector step over the remaining samples, so they use the same exp
+        if (i < xData.Length)
+        {
+            Span<float> tail = stackalloc float[width];
+            tail.Fill(mu1);
+            xData.Slice(i).CopyTo(tail);
+            var x = new Vector<float>(tail);
+            var norm1 = (x - vMu1) * vInv1;
+            var norm2 = (x - vMu2) * vInv2;
+            var predicted = vA1 * ExpPolynomialSingle(vNegHalf * norm1 * norm1)
+                          + vA2 * ExpPolynomialSingle(vNegHalf * norm2 * norm2);
+            for (int j = 0; i + j < xData.Length; j++)
+            {
+                float residual = yData[i + j] - predicted[j];
+                sumSquaredError += (double)(residual * residual);
+            }
+        }
+
+        return sumSquaredError;
+    }
+
+    /// <summary>
+    /// Polynomial exp for Vector&lt;float&gt;: Cody-Waite reduction with a float split of ln2 and the
+    /// degree-7 Cephes expf polynomial. Relative error stays below 8.3e-8 on [-87, 0]; inputs below -87
+    /// return 0.
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private static Vector<float> ExpPolynomialSingle(Vector<float> x)
+    {
+        var underflow = Vector.LessThan(x, new Vector<float>(-87f));
+        x = Vector.Max(x, new Vector<float>(-87f));
+
+        var k = Vector.Floor(x * new Vector<float>(1.44269504088896341f) + new Vector<float>(0.5f));
+        var r = x - k * new Vector<float>(0.693359375f);
+        r -= k * new Vector<float>(-2.12194440e-4f);
+
+        var p = new Vector<float>(1.9875691500e-4f);
+        p = p * r + new Vector<float>(1.3981999507e-3f);
+        p = p * r + new Vector<float>(8.3334519073e-3f);
+        p = p * r + new Vector<float>(4.1665795894e-2f);
+        p = p * r + new Vector<float>(1.6666665459e-1f);
+        p = p * r + new Vector<float>(5.0000001201e-1f);
+        p = p * (r * r) + r + Vector<float>.One;
+
+        // 2^k assembled directly in the exponent field
+        var bits = Vector.ShiftLeft(Vector.ConvertToInt32(k) + new Vector<int>(127), 23);
+        var result = p * Vector.AsVectorSingle(bits);
+        return Vector.ConditionalSelect(underflow, Vector<float>.Zero, result);
+    }
+
     [MethodImpl(MethodImplOptions.AggressiveInlining)]
     private static T SumSquaredResidualsInline<T>(
         ReadOnlySpan<T> parameters,
@@ -197,10 +419,97 @@ public static class DoubleGaussianOptimizedFixed
     /// Create optimized objective function for fitting
     /// </summary>
     public static Func<ReadOnlySpan<T>, T> CreateOptimizedObjective<T>(
-        T[] xData, T[] yData) where T : unmanaged, IFloatingPoint<T>
+        T[] xData, T[] yData, ExpMode expMode = ExpMode.Fast) where T : unmanaged, IFloatingPoint<T>
     {
         // Capture arrays to avoid span issues in lambda
-        return parameters => SumSquaredResidualsOptimized(parameters, xData, yData);
+        return parameters => SumSquaredResidualsOptimized(parameters, xData, yData, expMode);
+    }
+
+    /// <summary>
+    /// Same SSR as CreateOptimizedObjective as a struct objective, so FitOptimized runs a solver
+    /// specialized for it instead of calling through a delegate
+    /// </summary>
+    public readonly struct SumSquaredResidualsObjective<T> : IObjective<T> where T : unmanaged, IFloatingPoint<T>
+    {
+        private readonly T[] _xData;
+        private readonly T[] _yData;
+        private readonly ExpMode _expMode;
+
+        public SumSquaredResidualsObjective(T[] xData, T[] yData, ExpMode expMode = ExpMode.Fast)
+        {
+            _xData = xData;
+            _yData = yData;
+            _expMode = expMode;
+        }
+
+        public T Evaluate(ReadOnlySpan<T> parameters) =>
+            SumSquaredResidualsOptimized<T>(parameters, _xData, _yData, _expMode);
+    }
+
+    /// <summary>
+    /// Gauss-Newton normal equations in one pass over the data: J^T J (6x6, row-major)
+    /// into jtj and J^T r into jtr for r = y - model. Returns the sum of squared residuals.
+    /// </summary>
+    public static T NormalEquations<T>(
+        ReadOnlySpan<T> parameters,
+        ReadOnlySpan<T> xData,
+        ReadOnlySpan<T> yData,
+        Span<T> jtj,
+        Span<T> jtr) where T : unmanaged, IFloatingPoint<T>
+    {
+        if (xData.Length != yData.Length)
+            throw new ArgumentException("X and Y data must have the same length");
+
+        if (parameters.Length != 6 || jtj.Length < 36 || jtr.Length < 6)
+            throw new ArgumentException("Double Gaussian requires exactly 6 parameters");
+
+        T a1 = parameters[0];
+        T mu1 = parameters[1];
+        T sigma1 = parameters[2];
+        T a2 = parameters[3];
+        T mu2 = parameters[4];
+        T sigma2 = parameters[5];
+
+        T minSigma = T.CreateChecked(MinSigma);
+        if (sigma1 <= T.Zero) sigma1 = minSigma;
+        if (sigma2 <= T.Zero) sigma2 = minSigma;
+
+        T negHalf = T.CreateChecked(NegativeHalf);
+        T sumSquaredError = T.Zero;
+        Span<T> row = stackalloc T[6];
+        jtj.Slice(0, 36).Clear();
+        jtr.Slice(0, 6).Clear();
+
+        for (int i = 0; i < xData.Length; i++)
+        {
+            T z1 = (xData[i] - mu1) / sigma1;
+            T z2 = (xData[i] - mu2) / sigma2;
+            T e1 = T.CreateChecked(Math.Exp(double.CreateChecked(negHalf * z1 * z1)));
+            T e2 = T.CreateChecked(Math.Exp(double.CreateChecked(negHalf * z2 * z2)));
+            T residual = yData[i] - (a1 * e1 + a2 * e2);
+            sumSquaredError += residual * residual;
+
+            // Jacobian row: dg/dA = e, dg/dmu = A e z / sigma, dg/dsigma = z dg/dmu
+            row[0] = e1;
+            row[1] = a1 * e1 * z1 / sigma1;
+            row[2] = row[1] * z1;
+            row[3] = e2;
+            row[4] = a2 * e2 * z2 / sigma2;
+            row[5] = row[4] * z2;
+
+            for (int k = 0; k < 6; k++)
+            {
+                jtr[k] += row[k] * residual;
+                for (int l = k; l < 6; l++)
+                    jtj[k * 6 + l] += row[k] * row[l];
+            }
+        }
+
+        for (int k = 1; k < 6; k++)
+            for (int l = 0; l < k; l++)
+                jtj[k * 6 + l] = jtj[l * 6 + k];
+
+        return sumSquaredError;
     }
 
     /// <summary>
@@ -210,7 +519,8 @@ public static class DoubleGaussianOptimizedFixed
         ReadOnlySpan<T> xData,
         ReadOnlySpan<T> yData,
         ReadOnlySpan<T> initialGuess,
-        INelderMeadOptions<T>? options = null) where T : unmanaged, IFloatingPoint<T>
+        INelderMeadOptions<T>? options = null,
+        FitBackend backend = FitBackend.NelderMead) where T : unmanaged, IFloatingPoint<T>
     {
         if (initialGuess.Length != 6)
             throw new ArgumentException("Initial guess must have exactly 6 parameters for double Gaussian");
@@ -219,49 +529,91 @@ public static class DoubleGaussianOptimizedFixed
         var xArray = xData.ToArray();
         var yArray = yData.ToArray();
 
-        // Create optimized objective function
-        var objective = CreateOptimizedObjective<T>(xArray, yArray);
-        
+        if (backend == FitBackend.LevenbergMarquardt)
+            return FitLevenbergMarquardt(xArray, yArray, initialGuess, options);
+
+        var objective = new SumSquaredResidualsObjective<T>(xArray, yArray);
         return NelderMeadOptimized<T>.Minimize(objective, initialGuess, options);
     }
 
     /// <summary>
-    /// Generate intelligent initial guess with optimized calculations
+    /// Float32 fit with an optional polish in double. The Nelder-Mead run on float data uses the
+    /// Vector&lt;float&gt; SSR kernel; with polish set, a double run restarts from its solution with a
+    /// small initial simplex (1e-3 unless polishOptions says otherwise) on the same samples widened to
+    /// double. Evaluations and iterations are totals over both runs.
     /// </summary>
-    public static ReadOnlySpan<T> GenerateOptimizedInitialGuess<T>(
-        ReadOnlySpan<T> xData,
-        ReadOnlySpan<T> yData) where T : unmanaged, IFloatingPoint<T>
+    public static OptimizationResult<double> FitMixedPrecision(
+        ReadOnlySpan<float> xData,
+        ReadOnlySpan<float> yData,
+        ReadOnlySpan<double> initialGuess,
+        bool polish = true,
+        INelderMeadOptions<float>? singleOptions = null,
+        INelderMeadOptions<double>? polishOptions = null)
     {
-        if (xData.Length != yData.Length || xData.Length < 6)
-            throw new ArgumentException("Need at least 6 data points for double Gaussian fitting");
-
-        // Find peaks and estimate parameters efficiently
-        T maxY = T.Zero;
-        int maxIndex = 0;
-        T minX = xData[0];
-        T maxX = xData[0];
+        if (initialGuess.Length != 6)
+            throw new ArgumentException("Initial guess must have exactly 6 parameters for double Gaussian");
 
-        // Single pass to find min, max, and peak
-        for (int i = 0; i < yData.Length; i++)
+        // Tolerances below the float resolution of the SSR would only chase rounding noise
+        singleOptions ??= new NelderMeadOptions<float> { FunctionTolerance = 1e-6f, ParameterTolerance = 1e-6f };
+        var singleGuess = new float[6];
+        for (int i = 0; i < 6; i++) singleGuess[i] = (float)initialGuess[i];
+        var single = FitOptimized<float>(xData, yData, singleGuess, singleOptions);
+
+        var solution = new double[6];
+        var singleSolution = single.OptimalParameters.Span;
+        for (int i = 0; i < 6; i++) solution[i] = singleSolution[i];
+        if (!polish)
+            return new OptimizationResult<double>(solution, single.OptimalValue, single.Iterations,
+                single.FunctionEvaluations, single.Converged, single.Message);
+
+        var xWide = new double[xData.Length];
+        var yWide = new double[yData.Length];
+        for (int i = 0; i < xWide.Length; i++)
         {
-            if (yData[i] > maxY)
-            {
-                maxY = yData[i];
-                maxIndex = i;
-            }
-            if (xData[i] < minX) minX = xData[i];
-            if (xData[i] > maxX) maxX = xData[i];
+            xWide[i] = xData[i];
+            yWide[i] = yData[i];
         }
+        polishOptions ??= new NelderMeadOptions<double> { InitialSimplexSize = 1e-3 };
+        var polished = FitOptimized<double>(xWide, yWide, solution, polishOptions);
+        return new OptimizationResult<double>(polished.OptimalParameters, polished.OptimalValue,
+            single.Iterations + polished.Iterations,
+            single.FunctionEvaluations + polished.FunctionEvaluations,
+            polished.Converged, polished.Message);
+    }
 
-        T range = maxX - minX;
-        T quarter = range / T.CreateChecked(4);
-        
-        // Heuristic: assume two peaks at 1/4 and 3/4 of the range
-        T mu1 = minX + quarter;
-        T mu2 = minX + T.CreateChecked(3) * quarter;
-        T sigma = range / T.CreateChecked(8); // Estimate width
-        T amplitude = maxY / T.CreateChecked(2); // Split amplitude
+    /// <summary>
+    /// Least-squares fit on the Levenberg-Marquardt backend. Takes the iteration limit and
+    /// bounds from options and falls back to DoubleGaussian.GetDefaultBounds when none are given.
+    /// </summary>
+    private static OptimizationResult<T> FitLevenbergMarquardt<T>(
+        T[] xData,
+        T[] yData,
+        ReadOnlySpan<T> initialGuess,
+        INelderMeadOptions<T>? options) where T : unmanaged, IFloatingPoint<T>
+    {
+        var defaultBounds = DoubleGaussian.GetDefaultBounds<T>().ToArray();
+        var lmOptions = new LevenbergMarquardtOptions<T>
+        {
+            LowerBounds = options is { LowerBounds.IsEmpty: false } ? options.LowerBounds : defaultBounds.AsMemory(0, 6),
+            UpperBounds = options is { UpperBounds.IsEmpty: false } ? options.UpperBounds : defaultBounds.AsMemory(6, 6)
+        };
+        if (options != null)
+            lmOptions.MaxIterations = options.MaxIterations;
+
+        return LevenbergMarquardt<T>.Minimize(
+            (parameters, jtj, jtr) => NormalEquations<T>(parameters, xData, yData, jtj, jtr),
+            initialGuess,
+            lmOptions);
+    }
 
-        return new T[] { amplitude, mu1, sigma, amplitude, mu2, sigma };
+    /// <summary>
+    /// Generate intelligent initial guess from the peaks in the data
+    /// (see <see cref="DoubleGaussian.GeneratePeakInitialGuess{T}"/>)
+    /// </summary>
+    public static ReadOnlySpan<T> GenerateOptimizedInitialGuess<T>(
+        ReadOnlySpan<T> xData,
+        ReadOnlySpan<T> yData) where T : unmanaged, IFloatingPoint<T>
+    {
+        return DoubleGaussian.GeneratePeakInitialGuess(xData, yData);
     }
 }
\ No newline at end of file
@@ -0,0 +1,13 @@
+namespace Optimization.Core.Models;
+
+/// <summary>
+/// Exp used by the DoubleGaussianOptimizedFixed SSR kernels; mirrors ExpMode in Benchmarks/GaussianKernels.hpp
+/// </summary>
+public enum ExpMode
+{
+    /// <summary>Polynomial exp on Vector&lt;T&gt; lanes, within 1 ulp of Math.Exp for double</summary>
+    Fast,
+
+    /// <summary>Math.Exp per sample; the reference the fast path is validated against</summary>
+    Accurate
+}
@@ -0,0 +1,13 @@
+namespace Optimization.Core.Models;
+
+/// <summary>
+/// Optimizer used by DoubleGaussianOptimizedFixed.FitOptimized
+/// </summary>
+public enum FitBackend
+{
+    /// <summary>Derivative-free Nelder-Mead on the scalar SSR</summary>
+    NelderMead,
+
+    /// <summary>Levenberg-Marquardt on the residuals and their analytic Jacobian</summary>
+    LevenbergMarquardt
+}
@@ -0,0 +1,182 @@
+using System.Numerics;
+using System.Runtime.InteropServices;
+using Optimization.Core.Algorithms;
+
+namespace Optimization.Core.Models;
+
+/// <summary>
+/// Baseline terms added to a Gaussian mixture; their parameters follow the components,
+/// the offset first, then the slope
+/// </summary>
+[Flags]
+public enum GaussianBaseline
+{
+    None = 0,
+    Constant = 1,
+    Linear = 2
+}
+
+/// <summary>
+/// Mixture of 1 to 8 Gaussians with an optional constant and/or linear baseline. Parameters are
+/// [A1, μ1, σ1, ..., AK, μK, σK] followed by the baseline terms, so two components without a
+/// baseline is the DoubleGaussian layout. Double data takes a Vector&lt;double&gt; kernel that
+/// evaluates all components of a sample block in one pass (GaussianKernels::multi_gaussian_ssr
+/// on the native side).
+/// </summary>
+public sealed class MultiGaussian
+{
+    public const int MaxComponents = 8;
+
+    private static readonly double MinSigma = 1e-10;
+
+    public int Components { get; }
+    public GaussianBaseline Baseline { get; }
+    public int ParameterCount { get; }
+
+    public MultiGaussian(int components, GaussianBaseline baseline = GaussianBaseline.None)
+    {
+        if (components < 1 || components > MaxComponents)
+            throw new ArgumentOutOfRangeException(nameof(components), $"Multi-Gaussian takes 1 to {MaxComponents} components");
+
+        Components = components;
+        Baseline = baseline;
+        ParameterCount = 3 * components
+                       + (baseline.HasFlag(GaussianBaseline.Constant) ? 1 : 0)
+                       + (baseline.HasFlag(GaussianBaseline.Linear) ? 1 : 0);
+    }
+
+    public T Evaluate<T>(ReadOnlySpan<T> parameters, T x) where T : IFloatingPoint<T>
+    {
+        CheckParameters(parameters.Length);
+
+        (T offset, T slope) = BaselineTerms(parameters);
+        T sum = offset + slope * x;
+        T minSigma = T.CreateChecked(MinSigma);
+        T negativeHalf = -T.CreateChecked(0.5);
+        for (int k = 0; k < Components; k++)
+        {
+            T sigma = parameters[3 * k + 2];
+            if (sigma <= T.Zero) sigma = minSigma;
+            T normalized = (x - parameters[3 * k + 1]) / sigma;
+            sum += parameters[3 * k] * T.CreateChecked(Math.Exp(double.CreateChecked(negativeHalf * normalized * normalized)));
+        }
+        return sum;
+    }
+
+    public T SumSquaredResiduals<T>(
+        ReadOnlySpan<T> parameters,
+        ReadOnlySpan<T> xData,
+        ReadOnlySpan<T> yData) where T : unmanaged, IFloatingPoint<T>
+    {
+        if (xData.Length != yData.Length)
+            throw new ArgumentException("X and Y data must have the same length");
+        CheckParameters(parameters.Length);
+
+        if (typeof(T) == typeof(double) && Vector.IsHardwareAccelerated && xData.Length >= Vector<double>.Count)
+        {
+            double ssr = SumSquaredResidualsVector(
+                MemoryMarshal.Cast<T, double>(parameters),
+                MemoryMarshal.Cast<T, double>(xData),
+                MemoryMarshal.Cast<T, double>(yData));
+            return T.CreateChecked(ssr);
+        }
+
+        T sumSquaredError = T.Zero;
+        for (int i = 0; i < xData.Length; i++)
+        {
+            T residual = yData[i] - Evaluate(parameters, xData[i]);
+            sumSquaredError += residual * residual;
+        }
+        return sumSquaredError;
+    }
+
+    public OptimizationResult<T> Fit<T>(
+        ReadOnlySpan<T> xData,
+        ReadOnlySpan<T> yData,
+        ReadOnlySpan<T> initialGuess,
+        INelderMeadOptions<T>? options = null) where T : unmanaged, IFloatingPoint<T>
+    {
+        if (initialGuess.Length != ParameterCount)
+            throw new ArgumentException($"Initial guess must have {ParameterCount} parameters for this model");
+
+        var xArray = xData.ToArray();
+        var yArray = yData.ToArray();
+        return NelderMeadOptimized<T>.Minimize(parameters => SumSquaredResiduals<T>(parameters, xArray, yArray), initialGuess, options);
+    }
+
+    private void CheckParameters(int length)
+    {
+        if (length != ParameterCount)
+            throw new ArgumentException($"Multi-Gaussian with {Components} components and baseline {Baseline} requires {ParameterCount} parameters");
+    }
+
+    private (T Offset, T Slope) BaselineTerms<T>(ReadOnlySpan<T> parameters) where T : IFloatingPoint<T>
+    {
+        int next = 3 * Components;
+        T offset = Baseline.HasFlag(GaussianBaseline.Constant) ? parameters[next++] : T.Zero;
+        T slope = Baseline.HasFlag(GaussianBaseline.Linear) ? parameters[next] : T.Zero;
+        return (offset, slope);
+    }
+
+    private double SumSquaredResidualsVector(
+        ReadOnlySpan<double> parameters,
+        ReadOnlySpan<double> xData,
+        ReadOnlySpan<double> yData)
+    {
+        int components = Components;
+        Span<Vector<double>> amplitude = stackalloc Vector<double>[components];
+        Span<Vector<double>> mean = stackalloc Vector<double>[components];
+        Span<Vector<double>> inverseSigma = stackalloc Vector<double>[components];
+        for (int k = 0; k < components; k++)
+        {
+            double sigma = parameters[3 * k + 2] <= 0.0 ? MinSigma : parameters[3 * k + 2];
+            amplitude[k] = new Vector<double>(parameters[3 * k]);
+            mean[k] = new Vector<double>(parameters[3 * k + 1]);
+            inverseSigma[k] = new Vector<double>(1.0 / sigma);
+        }
+        (double offset, double slope) = BaselineTerms(parameters);
+        var vOffset = new Vector<double>(offset);
+        var vSlope = new Vector<double>(slope);
+        var vNegHalf = new Vector<double>(-0.5);
+        var accumulator = Vector<double>.Zero;
+
+        int width = Vector<double>.Count;
+        int i = 0;
+        for (; i <= xData.Length - width; i += width)
+        {
+            var x = new Vector<double>(xData.Slice(i, width));
+            var predicted = vOffset + vSlope * x;
+            for (int k = 0; k < components; k++)
+            {
+                var normalized = (x - mean[k]) * inverseSigma[k];
+                predicted += amplitude[k] * DoubleGaussianOptimizedFixed.ExpPolynomial(vNegHalf * normalized * normalized);
+            }
+            var residual = new Vector<double>(yData.Slice(i, width)) - predicted;
+            accumulator += residual * residual;
+        }
+
+        double sumSquaredError = Vector.Sum(accumulator);
+
+        // Tail: one more vector step over the remaining samples, so they use the same exp
+        if (i < xData.Length)
+        {
+            Span<double> tail = stackalloc double[width];
+            tail.Fill(parameters[1]);
+            xData.Slice(i).CopyTo(tail);
+            var x = new Vector<double>(tail);
+            var predicted = vOffset + vSlope * x;
+            for (int k = 0; k < components; k++)
+            {
+                var normalized = (x - mean[k]) * inverseSigma[k];
+                predicted += amplitude[k] * DoubleGaussianOptimizedFixed.ExpPolynomial(vNegHalf * normalized * normalized);
+            }
+            for (int j = 0; i + j < xData.Length; j++)
+            {
+                double residual = yData[i + j] - predicted[j];
+                sumSquaredError += residual * residual;
+            }
+        }
+
+        return sumSquaredError;
+    }
+}
\ No newline at end of file
@@ -137,4 +137,271 @@ public class AlgorithmTests
         Assert.True(result.FunctionEvaluations > 0);
         Assert.True(result.FunctionEvaluations >= result.Iterations);
     }
+
+    [Fact]
+    public void NelderMeadOptimized_TraceAccountsForEveryEvaluation()
+    {
+        static double Rosenbrock(ReadOnlySpan<double> x) =>
+            Math.Pow(1.0 - x[0], 2) + 100.0 * Math.Pow(x[1] - x[0] * x[0], 2);
+
+        var trace = new SolverTrace();
+        var options = new NelderMeadOptions<double> { FunctionTolerance = 1e-10, MaxIterations = 2000 };
+
+        var result = NelderMeadOptimized<double>.Minimize(Rosenbrock, new double[] { -1.2, 1.0 }, options, trace);
+
+        Assert.Equal(result.FunctionEvaluations, trace.Evaluations);
+        Assert.Equal(result.Iterations, trace.Iterations);
+        Assert.Equal(3, trace.OperationEvaluationsOf(NelderMeadOperation.Initialize));
+        Assert.True(trace.History.Count > 1);
+        Assert.Equal(result.OptimalValue, trace.History[^1].BestValue);
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_IncrementalCentroidConvergesInTenDimensions()
+    {
+        // Thousands of worst-vertex replacements and shrinks: the running vertex sum
+        // must not drift away from the simplex it summarizes
+        static double Sphere(ReadOnlySpan<double> x)
+        {
+            double sum = 0;
+            foreach (var value in x) sum += value * value;
+            return sum;
+        }
+
+        var options = new NelderMeadOptions<double> { FunctionTolerance = 1e-12, MaxIterations = 50000 };
+        var result = NelderMeadOptimized<double>.Minimize(Sphere, Enumerable.Repeat(1.0, 10).ToArray(), options);
+
+        Assert.True(result.Converged);
+        Assert.True(result.FunctionEvaluations > 1000);
+        Assert.All(result.OptimalParameters.ToArray(), value => Assert.InRange(value, -1e-4, 1e-4));
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_StopsOnParameterTolerance()
+    {
+        // Quartic valley floor: the values flatten long before the simplex is small
+        static double Valley(ReadOnlySpan<double> x) => Math.Pow(x[0] - 1.0, 4) + (x[1] - 2.0) * (x[1] - 2.0);
+
+        var options = new NelderMeadOptions<double>
+        {
+            FunctionTolerance = 0.0,
+            ParameterTolerance = 1e-6,
+            MaxIterations = 10000
+        };
+        var result = NelderMeadOptimized<double>.Minimize(Valley, new double[] { 3.0, 3.0 }, options);
+
+        Assert.True(result.Converged);
+        Assert.Equal("Parameter tolerance reached", result.Message);
+        Assert.InRange(result.OptimalParameters.Span[1], 2.0 - 1e-5, 2.0 + 1e-5);
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_StopsOnRelativeFunctionTolerance()
+    {
+        static double Rosenbrock(ReadOnlySpan<double> x) =>
+            Math.Pow(1.0 - x[0], 2) + 100.0 * Math.Pow(x[1] - x[0] * x[0], 2);
+
+        var options = new NelderMeadOptions<double>
+        {
+            FunctionTolerance = 0.0,
+            ParameterTolerance = 0.0,
+            RelativeFunctionTolerance = 1e-8,
+            MaxIterations = 10000
+        };
+        var result = NelderMeadOptimized<double>.Minimize(Rosenbrock, new double[] { -1.2, 1.0 }, options);
+
+        Assert.True(result.Converged);
+        Assert.Equal("Function tolerance reached", result.Message);
+        Assert.True(result.OptimalValue < 1e-12);
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_RespectsEvaluationAndTimeBudgets()
+    {
+        static double Sphere(ReadOnlySpan<double> x)
+        {
+            double sum = 0;
+            foreach (var value in x) sum += value * value;
+            return sum;
+        }
+
+        var initialGuess = Enumerable.Repeat(1.0, 20).ToArray();
+        var byEvaluations = NelderMeadOptimized<double>.Minimize(Sphere, initialGuess, new NelderMeadOptions<double>
+        {
+            MaxIterations = 100000,
+            MaxFunctionEvaluations = 1000
+        });
+
+        Assert.False(byEvaluations.Converged);
+        Assert.Equal("Maximum evaluations reached", byEvaluations.Message);
+        Assert.InRange(byEvaluations.FunctionEvaluations, 1000, 1000 + initialGuess.Length + 1);
+
+        var byTime = NelderMeadOptimized<double>.Minimize(x => { Thread.SpinWait(1000); return Sphere(x); }, initialGuess, new NelderMeadOptions<double>
+        {
+            FunctionTolerance = 0.0,
+            ParameterTolerance = 0.0,
+            MaxIterations = int.MaxValue,
+            MaxTime = TimeSpan.FromMilliseconds(20)
+        });
+
+        Assert.False(byTime.Converged);
+        Assert.Equal("Maximum time reached", byTime.Message);
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_EvaluationCacheKeepsPathAndSkipsRepeats()
+    {
+        int calls = 0;
+        double Sphere(ReadOnlySpan<double> x)
+        {
+            calls++;
+            double sum = 0;
+            foreach (var value in x) sum += (value - 1.0) * (value - 1.0);
+            return sum;
+        }
+
+        // Zero tolerances run the simplex down to rounding level, where shrinks and
+        // contractions keep landing on vertices it already has
+        NelderMeadOptions<double> Options(int cacheSize) => new()
+        {
+            FunctionTolerance = 0.0,
+            ParameterTolerance = 0.0,
+            MaxIterations = 20000,
+            MaxFunctionEvaluations = 20000,
+            CacheSize = cacheSize
+        };
+        var initialGuess = new double[] { -1.2, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+        var uncached = NelderMeadOptimized<double>.Minimize(Sphere, initialGuess, Options(0));
+        int uncachedCalls = calls;
+        calls = 0;
+        var trace = new SolverTrace();
+        var cached = NelderMeadOptimized<double>.Minimize(Sphere, initialGuess, Options(64), trace);
+
+        Assert.Equal(uncached.OptimalValue, cached.OptimalValue);
+        Assert.Equal(uncached.FunctionEvaluations, cached.FunctionEvaluations);
+        Assert.Equal(uncachedCalls, calls + trace.CacheHits);
+        Assert.Equal(calls, trace.CacheMisses);
+        Assert.True(trace.CacheHits > calls);
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_ConfiningBoundsModesNeverEvaluateOutsideTheBox()
+    {
+        // Optimum of the unconstrained quadratic at (-1, 3) lies outside the box [0, 2]^2;
+        // the constrained one is on the face x = 0
+        bool outside = false;
+        double Shifted(ReadOnlySpan<double> x)
+        {
+            for (int i = 0; i < x.Length; i++)
+                outside |= x[i] < 0.0 || x[i] > 2.0;
+            return (x[0] + 1.0) * (x[0] + 1.0) + (x[1] - 1.0) * (x[1] - 1.0);
+        }
+
+        foreach (var mode in new[] { BoundsMode.Project, BoundsMode.Reflect })
+        {
+            outside = false;
+            var options = new NelderMeadOptions<double>
+            {
+                LowerBounds = new double[] { 0.0, 0.0 },
+                UpperBounds = new double[] { 2.0, 2.0 },
+                BoundsMode = mode
+            };
+
+            var result = NelderMeadOptimized<double>.Minimize(Shifted, new double[] { 1.5, 1.5 }, options);
+
+            Assert.True(result.Converged);
+            Assert.False(outside);
+            Assert.True(Math.Abs(result.OptimalParameters.Span[0]) < 1e-6);
+            Assert.True(Math.Abs(result.OptimalParameters.Span[1] - 1.0) < 1e-3);
+            Assert.True(Math.Abs(result.OptimalValue - 1.0) < 1e-6);
+        }
+    }
+
+    private sealed class CallCounter
+    {
+        public int Calls;
+    }
+
+    private readonly struct CountingRosenbrock : IObjective<double>
+    {
+        private readonly CallCounter _counter;
+
+        public CountingRosenbrock(CallCounter counter) => _counter = counter;
+
+        public double Evaluate(ReadOnlySpan<double> x)
+        {
+            _counter.Calls++;
+            return (1 - x[0]) * (1 - x[0]) + 100 * (x[1] - x[0] * x[0]) * (x[1] - x[0] * x[0]);
+        }
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_StructObjectiveMatchesDelegatePath()
+    {
+        var initialGuess = new double[] { -1.2, 1.0 };
+        var options = new NelderMeadOptions<double> { MaxIterations = 2000 };
+        var counter = new CallCounter();
+        var objective = new CountingRosenbrock(counter);
+
+        var viaStruct = NelderMeadOptimized<double>.Minimize(objective, initialGuess, options);
+        int structCalls = counter.Calls;
+        counter.Calls = 0;
+        var viaDelegate = NelderMeadOptimized<double>.Minimize(x => objective.Evaluate(x), initialGuess, options);
+
+        Assert.True(viaStruct.Converged);
+        Assert.Equal(viaDelegate.OptimalValue, viaStruct.OptimalValue);
+        Assert.Equal(viaDelegate.FunctionEvaluations, viaStruct.FunctionEvaluations);
+        Assert.Equal(viaStruct.FunctionEvaluations, structCalls);
+        Assert.Equal(structCalls, counter.Calls);
+    }
+
+    private readonly struct ShiftedSphere : IObjective<double>
+    {
+        public double Evaluate(ReadOnlySpan<double> x)
+        {
+            double sum = 0;
+            for (int i = 0; i < x.Length; i++) sum += (x[i] - i) * (x[i] - i);
+            return sum;
+        }
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_RepeatedFitsReuseTheThreadWorkspace()
+    {
+        const int n = 10;
+        var initialGuess = new double[n];
+        var options = new NelderMeadOptions<double> { MaxIterations = 5000 };
+        var results = new double[3 * n];
+
+        var first = NelderMeadOptimized<double>.Minimize(new ShiftedSphere(), initialGuess, results.AsMemory(0, n), options);
+        var second = NelderMeadOptimized<double>.Minimize(new ShiftedSphere(), initialGuess, results.AsMemory(n, n), options);
+        long before = GC.GetAllocatedBytesForCurrentThread();
+        var third = NelderMeadOptimized<double>.Minimize(new ShiftedSphere(), initialGuess, results.AsMemory(2 * n, n), options);
+        long allocated = GC.GetAllocatedBytesForCurrentThread() - before;
+
+        // The scratch arrays alone take over 2 KB at n = 10; what is left is the run object
+        Assert.True(allocated < 512, $"Allocated {allocated} bytes");
+        Assert.Equal(first.FunctionEvaluations, second.FunctionEvaluations);
+        Assert.Equal(first.FunctionEvaluations, third.FunctionEvaluations);
+        Assert.Equal(first.OptimalValue, third.OptimalValue);
+        Assert.True(results.AsSpan(0, n).SequenceEqual(results.AsSpan(2 * n, n)));
+        Assert.True(third.OptimalParameters.Span.SequenceEqual(results.AsSpan(2 * n, n)));
+    }
+
+    [Fact]
+    public void NelderMeadOptimized_DisposedRunRejectsWorkspaceAccess()
+    {
+        var run = NelderMeadOptimized<double>.Start(new ShiftedSphere(), new double[4]);
+        run.Step(10);
+        int evaluations = run.FunctionEvaluations;
+        run.Dispose();
+
+        // The workspace may already belong to the next run on this thread
+        using var next = NelderMeadOptimized<double>.Start(new ShiftedSphere(), new double[4]);
+        Assert.Throws<ObjectDisposedException>(() => run.Step(1));
+        Assert.Throws<ObjectDisposedException>(() => run.BestValue);
+        Assert.Throws<ObjectDisposedException>(() => run.BestPoint.ToArray());
+        Assert.Equal(evaluations, run.FunctionEvaluations);
+    }
 }
\ No newline at end of file
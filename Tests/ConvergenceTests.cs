@@ -227,4 +227,130 @@ public class ConvergenceTests
         // Should achieve very good fit even with different scales
         Assert.True(result.OptimalValue < 1e-4);
     }
+
+    [Fact]
+    public void MultiStart_FindsAllHimmelblauMinima()
+    {
+        static double Himmelblau(ReadOnlySpan<double> x) =>
+            Math.Pow(x[0] * x[0] + x[1] - 11, 2) + Math.Pow(x[0] + x[1] * x[1] - 7, 2);
+
+        var options = new MultiStartOptions<double>
+        {
+            Starts = 16,
+            Seed = 3,
+            LocalOptions = new NelderMeadOptions<double>
+            {
+                LowerBounds = new double[] { -5.0, -5.0 },
+                UpperBounds = new double[] { 5.0, 5.0 },
+                FunctionTolerance = 1e-12,
+                ParameterTolerance = 1e-10,
+                MaxIterations = 5000
+            }
+        };
+
+        var result = MultiStartNelderMead<double>.Minimize(Himmelblau, options);
+
+        // Four minima of value 0, all inside the box
+        Assert.Equal(4, result.LocalMinima.Count);
+        Assert.All(result.LocalMinima, m => Assert.True(m.OptimalValue < 1e-8));
+        Assert.True(result.Best.OptimalValue <= result.LocalMinima[^1].OptimalValue);
+    }
+
+    [Fact]
+    public void MultiStart_PrunesLosingDoubleGaussianStarts()
+    {
+        var trueParams = new double[] { 2.0, -1.5, 0.5, 1.0, 1.5, 0.8 };
+        var random = new Random(1);
+        var xData = new double[200];
+        var yData = new double[200];
+        for (int i = 0; i < 200; i++)
+        {
+            xData[i] = -5.0 + 10.0 * i / 199.0;
+            yData[i] = DoubleGaussian.Evaluate<double>(trueParams, xData[i]) + 0.005 * random.NextGaussian();
+        }
+
+        double Objective(ReadOnlySpan<double> p) => DoubleGaussianOptimizedFixed.SumSquaredResidualsOptimized<double>(p, xData, yData);
+
+        MultiStartResult<double> Run(double pruneGap) => MultiStartNelderMead<double>.Minimize(Objective, new MultiStartOptions<double>
+        {
+            Starts = 12,
+            Seed = 7,
+            PruneGap = pruneGap,
+            LocalOptions = new NelderMeadOptions<double>
+            {
+                LowerBounds = new double[] { 0.0, -5.0, 0.1, 0.0, -5.0, 0.1 },
+                UpperBounds = new double[] { 3.0, 5.0, 2.0, 3.0, 5.0, 2.0 },
+                MaxIterations = 5000
+            }
+        });
+
+        var pruned = Run(0.5);
+        var exhaustive = Run(double.PositiveInfinity);
+
+        Assert.Equal(0, exhaustive.Pruned);
+        Assert.True(pruned.Pruned > 0);
+        Assert.True(pruned.FunctionEvaluations < exhaustive.FunctionEvaluations / 2);
+        Assert.True(pruned.Best.OptimalValue <= exhaustive.Best.OptimalValue * 1.01);
+
+        // The narrower peak on the left, whichever slot it ended up in
+        var best = pruned.Best.OptimalParameters.Span;
+        int left = best[1] < best[4] ? 0 : 3;
+        Assert.True(Math.Abs(best[left + 1] - trueParams[1]) < 0.05);
+        Assert.True(Math.Abs(best[left + 2] - trueParams[2]) < 0.05);
+    }
+
+    [Fact]
+    public void NelderMead_AdaptiveCoefficientsSpeedUpHighDimensions()
+    {
+        static double Sphere(ReadOnlySpan<double> x)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < x.Length; i++) sum += x[i] * x[i];
+            return sum;
+        }
+
+        var initialGuess = Enumerable.Repeat(1.0, 20).ToArray();
+        NelderMeadOptions<double> Options(bool adaptive) => new()
+        {
+            FunctionTolerance = 1e-10,
+            MaxIterations = 20000,
+            Adaptive = adaptive
+        };
+
+        var standard = NelderMeadOptimized<double>.Minimize(Sphere, initialGuess, Options(false));
+        var adaptive = NelderMeadOptimized<double>.Minimize(Sphere, initialGuess, Options(true));
+
+        Assert.True(adaptive.Converged);
+        Assert.True(adaptive.OptimalValue < 1e-8);
+        Assert.True(adaptive.FunctionEvaluations < standard.FunctionEvaluations / 2);
+    }
+
+    [Fact]
+    public void NelderMead_RestartRecoversFromFalseConvergence()
+    {
+        // Ill-conditioned ellipsoid on which the classic simplex collapses far from the origin
+        static double Ellipsoid(ReadOnlySpan<double> x)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < x.Length; i++)
+                sum += Math.Pow(10.0, 6.0 * i / (x.Length - 1)) * x[i] * x[i];
+            return sum;
+        }
+
+        var initialGuess = Enumerable.Repeat(1.0, 10).ToArray();
+        NelderMeadOptions<double> Options(int restarts) => new()
+        {
+            FunctionTolerance = 1e-10,
+            MaxIterations = 20000,
+            MaxRestarts = restarts
+        };
+
+        var single = NelderMeadOptimized<double>.Minimize(Ellipsoid, initialGuess, Options(0));
+        var restarted = NelderMeadOptimized<double>.Minimize(Ellipsoid, initialGuess, Options(5));
+
+        Assert.True(single.OptimalValue > 1.0);
+        Assert.Equal(0, single.Restarts);
+        Assert.True(restarted.Restarts > 0);
+        Assert.True(restarted.OptimalValue < 1e-8);
+    }
 }
\ No newline at end of file
@@ -110,6 +110,87 @@ public class DoubleGaussianTests
         Assert.True(guess[5] > 0); // σ2
     }
 
+    [Fact]
+    public void DoubleGaussian_GeneratePeakInitialGuessFindsSkewedPeaks()
+    {
+        // Narrow tall peak and wide low one, off centre
+        var trueParams = new double[] { 2.0, -1.8, 0.3, 0.6, 0.9, 0.9 };
+        var xData = new double[500];
+        var yData = new double[500];
+        var random = new Random(42);
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -3.0 + 6.0 * i / 499.0;
+            yData[i] = DoubleGaussian.Evaluate<double>(trueParams, xData[i]) + 0.01 * random.NextGaussian();
+        }
+
+        var guess = DoubleGaussian.GeneratePeakInitialGuess<double>(xData, yData).ToArray();
+        Assert.Equal(-1.8, guess[1], 0.1);
+        Assert.Equal(0.9, guess[4], 0.1);
+        Assert.Equal(0.3, guess[2], 0.1);
+        Assert.Equal(2.0, guess[0], 0.2);
+
+        var options = new NelderMeadOptions<double> { FunctionTolerance = 1e-10, MaxIterations = 5000 };
+        var fromPeaks = DoubleGaussian.Fit<double>(xData, yData, guess, options);
+        var fromRange = DoubleGaussian.Fit<double>(xData, yData,
+            DoubleGaussian.GenerateInitialGuess<double>(xData, yData), options);
+        Assert.True(fromPeaks.Converged);
+        Assert.True(fromPeaks.FunctionEvaluations < fromRange.FunctionEvaluations);
+        Assert.Equal(-1.8, fromPeaks.OptimalParameters.Span[1], 0.02);
+    }
+
+    [Fact]
+    public void DoubleGaussian_GeneratePeakInitialGuessSplitsPeakWiderThanData()
+    {
+        // Never falls to half its height inside the data, so there are no crossings
+        var xData = new double[200];
+        var yData = new double[200];
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -3.0 + 6.0 * i / 199.0;
+            yData[i] = 2.0 * Math.Exp(-0.5 * (xData[i] - 0.5) * (xData[i] - 0.5) / 25.0);
+        }
+
+        var guess = DoubleGaussian.GeneratePeakInitialGuess<double>(xData, yData).ToArray();
+        Assert.True(guess[4] - guess[1] >= 1.5 - 1e-9);
+        Assert.NotEqual(guess[2], guess[5]);
+        Assert.True(guess[0] > 0 && guess[3] > 0);
+    }
+
+    [Theory]
+    [InlineData(7)]
+    [InlineData(1000)]
+    public void DoubleGaussian_GeneratePeakInitialGuessSplitsSymmetricPeak(int count)
+    {
+        // One symmetric Gaussian: both half widths agree, so there is no wider side
+        var trueParams = new double[] { 2.0, 5.0, 1.0, 0.0, 5.0, 1.0 };
+        var xData = new double[count];
+        var yData = new double[count];
+        for (int i = 0; i < count; i++)
+        {
+            xData[i] = 2.0 + 6.0 * i / (count - 1.0);
+            yData[i] = DoubleGaussian.Evaluate<double>(trueParams, xData[i]);
+        }
+
+        var guess = DoubleGaussian.GeneratePeakInitialGuess<double>(xData, yData).ToArray();
+        Assert.NotEqual(guess[1], guess[4]);
+        Assert.NotEqual(guess[2], guess[5]);
+        double top = DoubleGaussian.Evaluate<double>(guess, 5.0);
+        Assert.InRange(top, 1.0, 3.0);
+    }
+
+    [Fact]
+    public void DoubleGaussian_GeneratePeakInitialGuessFallsBackForUnsortedData()
+    {
+        var xData = new double[] { 3, -2, -1, 0, 1, 2, 4 };
+        var yData = new double[] { 0.6, 0.1, 0.5, 1.0, 0.8, 0.3, 0.2 };
+
+        var guess = DoubleGaussian.GeneratePeakInitialGuess<double>(xData, yData).ToArray();
+        var fallback = DoubleGaussian.GenerateInitialGuess<double>(xData, yData).ToArray();
+
+        Assert.Equal(fallback, guess);
+    }
+
     [Fact]
     public void ObjectiveFunctions_SumSquaredResidualsWorksCorrectly()
     {
@@ -129,6 +210,133 @@ public class DoubleGaussianTests
         Assert.True(Math.Abs(ssr) < 1e-10);
     }
 
+    [Fact]
+    public void DoubleGaussianOptimized_VectorizedResidualsMatchReference()
+    {
+        // Odd length exercises both the Vector<double> loop and the padded tail step
+        var parameters = new double[] { 1.5, -0.8, 0.6, 1.2, 1.0, 0.4 };
+        var xData = new double[503];
+        var yData = new double[503];
+
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -30.0 + 60.0 * i / 502.0;
+            yData[i] = 2.0 * Math.Sin(i);
+        }
+
+        double expected = ObjectiveFunctions.SumSquaredResiduals<double>(parameters, xData, yData);
+        double actual = DoubleGaussianOptimizedFixed.SumSquaredResidualsOptimized<double>(parameters, xData, yData);
+
+        Assert.True(Math.Abs(actual - expected) / expected < 1e-12);
+    }
+
+    [Fact]
+    public void DoubleGaussianOptimized_ExpModesAgree()
+    {
+        var parameters = new double[] { 1.5, -0.8, 0.6, 1.2, 1.0, 0.4 };
+        var xData = new double[503];
+        var yData = new double[503];
+
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -3.0 + 6.0 * i / 502.0;
+            yData[i] = DoubleGaussian.Evaluate<double>(parameters, xData[i]) + 0.01 * Math.Sin(i);
+        }
+
+        double expected = ObjectiveFunctions.SumSquaredResiduals<double>(parameters, xData, yData);
+        double accurate = DoubleGaussianOptimizedFixed.SumSquaredResidualsOptimized<double>(
+            parameters, xData, yData, ExpMode.Accurate);
+        double fast = DoubleGaussianOptimizedFixed.SumSquaredResidualsOptimized<double>(
+            parameters, xData, yData, ExpMode.Fast);
+
+        Assert.True(Math.Abs(accurate - expected) / expected < 1e-12);
+        Assert.True(Math.Abs(fast - accurate) / accurate < 1e-10);
+    }
+
+    [Fact]
+    public void DoubleGaussianOptimized_SingleVectorizedResidualsMatchReference()
+    {
+        // Odd length exercises both the Vector<float> loop and the padded tail step
+        var parameters = new float[] { 1.5f, -0.8f, 0.6f, 1.2f, 1.0f, 0.4f };
+        var xData = new float[503];
+        var yData = new float[503];
+
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -30f + 60f * i / 502f;
+            yData[i] = 2f * MathF.Sin(i);
+        }
+
+        double expected = ObjectiveFunctions.SumSquaredResiduals<double>(
+            parameters.Select(p => (double)p).ToArray(),
+            xData.Select(x => (double)x).ToArray(),
+            yData.Select(y => (double)y).ToArray());
+        float actual = DoubleGaussianOptimizedFixed.SumSquaredResidualsOptimized<float>(parameters, xData, yData);
+
+        Assert.True(Math.Abs(actual - expected) / expected < 1e-6);
+    }
+
+    [Fact]
+    public void DoubleGaussianOptimized_MixedPrecisionPolishMatchesDoubleFit()
+    {
+        var trueParams = new double[] { 1.5, -0.8, 0.6, 1.2, 1.0, 0.4 };
+        var xData = new float[1000];
+        var yData = new float[1000];
+        var random = new Random(42);
+
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -3f + 6f * i / 999f;
+            yData[i] = (float)(DoubleGaussian.Evaluate<double>(trueParams, xData[i]) + 0.01 * random.NextGaussian());
+        }
+
+        var xWide = xData.Select(x => (double)x).ToArray();
+        var yWide = yData.Select(y => (double)y).ToArray();
+        var initialGuess = DoubleGaussian.GeneratePeakInitialGuess<double>(xWide, yWide);
+        var single = DoubleGaussianOptimizedFixed.FitMixedPrecision(xData, yData, initialGuess, polish: false);
+        var polished = DoubleGaussianOptimizedFixed.FitMixedPrecision(xData, yData, initialGuess);
+        var reference = DoubleGaussianOptimizedFixed.FitOptimized<double>(xWide, yWide, initialGuess);
+
+        Assert.True(single.Converged);
+        Assert.True(polished.Converged);
+        Assert.True(polished.OptimalValue <= single.OptimalValue * (1 + 1e-6));
+        Assert.True(Math.Abs(polished.OptimalValue - reference.OptimalValue) / reference.OptimalValue < 1e-6);
+        for (int i = 0; i < 6; i++)
+        {
+            Assert.True(Math.Abs(single.OptimalParameters.Span[i] - reference.OptimalParameters.Span[i]) < 1e-3,
+                $"Parameter {i}: float {single.OptimalParameters.Span[i]}, double {reference.OptimalParameters.Span[i]}");
+        }
+    }
+
+    [Fact]
+    public void DoubleGaussianOptimized_LevenbergMarquardtBackendFitsKnownData()
+    {
+        var trueParams = new double[] { 1.5, -0.8, 0.6, 1.2, 1.0, 0.4 };
+        var xData = new double[500];
+        var yData = new double[500];
+        var random = new Random(42);
+
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -3.0 + 6.0 * i / 499.0;
+            yData[i] = DoubleGaussian.Evaluate<double>(trueParams, xData[i]) + 0.01 * random.NextGaussian();
+        }
+
+        var initialGuess = new double[] { 1.0, 0.5, 0.8, 0.8, 1.5, 0.6 };
+        var result = DoubleGaussianOptimizedFixed.FitOptimized<double>(
+            xData, yData, initialGuess, backend: FitBackend.LevenbergMarquardt);
+
+        Assert.True(result.Converged);
+        Assert.True(result.FunctionEvaluations < 100);
+
+        var fitted = result.OptimalParameters.Span;
+        for (int i = 0; i < 6; i++)
+        {
+            Assert.True(Math.Abs(fitted[i] - trueParams[i]) < 0.05,
+                $"Parameter {i}: expected {trueParams[i]}, got {fitted[i]}");
+        }
+    }
+
     [Theory]
     [InlineData(1.0, 0.0, 1.0, 0.0)]
     [InlineData(2.0, 1.0, 0.5, 1.0)]
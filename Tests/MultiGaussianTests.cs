@@ -0,0 +1,88 @@
+using Xunit;
+using Optimization.Core.Models;
+using Optimization.Core.Algorithms;
+
+namespace Optimization.Core.Tests;
+
+public class MultiGaussianTests
+{
+    [Fact]
+    public void MultiGaussian_TwoComponentsMatchDoubleGaussian()
+    {
+        var parameters = new double[] { 1.5, -0.8, 0.6, 1.2, 1.0, 0.4 };
+        var model = new MultiGaussian(2);
+
+        Assert.Equal(6, model.ParameterCount);
+        for (double x = -3.0; x <= 3.0; x += 0.25)
+        {
+            double expected = DoubleGaussian.Evaluate<double>(parameters, x);
+            Assert.True(Math.Abs(model.Evaluate<double>(parameters, x) - expected) < 1e-14);
+        }
+    }
+
+    [Fact]
+    public void MultiGaussian_VectorizedResidualsMatchReference()
+    {
+        // Five components plus both baseline terms, on a length with a padded tail step
+        var parameters = new double[] { 1.0, -2.0, 0.3, 0.8, -1.0, 0.4, 1.2, 0.0, 0.5, 0.6, 1.0, 0.3, 0.9, 2.0, 0.6, 0.2, 0.05 };
+        var model = new MultiGaussian(5, GaussianBaseline.Constant | GaussianBaseline.Linear);
+        var xData = new double[503];
+        var yData = new double[503];
+        double reference = 0.0;
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -3.0 + 6.0 * i / 502.0;
+            yData[i] = Math.Sin(i);
+            double residual = yData[i] - model.Evaluate<double>(parameters, xData[i]);
+            reference += residual * residual;
+        }
+
+        double ssr = model.SumSquaredResiduals<double>(parameters, xData, yData);
+
+        Assert.True(Math.Abs(ssr - reference) / reference < 1e-13);
+    }
+
+    [Fact]
+    public void MultiGaussian_FitsThreeComponentsOnLinearBaseline()
+    {
+        var trueParams = new double[] { 1.5, -2.0, 0.5, 1.0, 0.0, 0.5, 1.2, 2.0, 0.5, 0.2, 0.05 };
+        var model = new MultiGaussian(3, GaussianBaseline.Constant | GaussianBaseline.Linear);
+        var xData = new double[300];
+        var yData = new double[300];
+        for (int i = 0; i < xData.Length; i++)
+        {
+            xData[i] = -4.0 + 8.0 * i / 299.0;
+            yData[i] = model.Evaluate<double>(trueParams, xData[i]);
+        }
+
+        var initialGuess = new double[] { 1.2, -1.9, 0.6, 0.8, 0.1, 0.6, 1.0, 2.1, 0.6, 0.0, 0.0 };
+        var options = new NelderMeadOptions<double>
+        {
+            FunctionTolerance = 1e-12,
+            ParameterTolerance = 1e-10,
+            MaxIterations = 20000
+        };
+
+        var result = model.Fit<double>(xData, yData, initialGuess, options);
+
+        Assert.True(result.OptimalValue < 1e-6);
+        for (int p = 0; p < trueParams.Length; p++)
+            Assert.True(Math.Abs(result.OptimalParameters.Span[p] - trueParams[p]) < 1e-2);
+    }
+
+    [Theory]
+    [InlineData(0)]
+    [InlineData(9)]
+    public void MultiGaussian_RejectsUnsupportedComponentCounts(int components)
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() => new MultiGaussian(components));
+    }
+
+    [Fact]
+    public void MultiGaussian_RejectsWrongParameterCount()
+    {
+        var model = new MultiGaussian(3, GaussianBaseline.Constant);
+
+        Assert.Throws<ArgumentException>(() => model.Evaluate<double>(new double[9], 0.0));
+    }
+}
\ No newline at end of file
@@ -237,6 +237,7 @@ public static class NLoptEquivalence
                 Console.WriteLine($"  Average parameter error: {avgError:E3}");
                 Console.WriteLine($"  Maximum parameter error: {maxError:E3}");
             }
+            PrintMultiStartSummary(testCase);
             Console.WriteLine();
         }
 
@@ -314,6 +315,24 @@ public static class NLoptEquivalence
         return results;
     }
 
+    // The same starting points run together, with losing starts pruned
+    private static void PrintMultiStartSummary(TestCase testCase)
+    {
+        var multiStart = MultiStartNelderMead<double>.Minimize(testCase.Function, new MultiStartOptions<double>
+        {
+            StartingPoints = testCase.StartingPoints,
+            LocalOptions = new NelderMeadOptions<double>
+            {
+                FunctionTolerance = 1e-12,
+                ParameterTolerance = 1e-12,
+                MaxIterations = 10000
+            }
+        });
+        var paramError = CalculateParameterError(multiStart.Best.OptimalParameters.Span, testCase.KnownSolution.point);
+        Console.WriteLine($"  Multi-start: error {paramError:E3}, {multiStart.LocalMinima.Count} distinct minima, " +
+                          $"{multiStart.Pruned}/{multiStart.Starts} pruned, {multiStart.FunctionEvaluations} evaluations");
+    }
+
     private static double CalculateParameterError(ReadOnlySpan<double> computed, ReadOnlySpan<double> expected)
     {
         double maxError = 0;